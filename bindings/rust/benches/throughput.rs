@@ -0,0 +1,120 @@
+//! Throughput of the bindings against the standard library equivalents
+//!
+//!   cargo bench                       # all groups
+//!   cargo bench -- from_utf8/65536    # one group and size
+
+use std::hint::black_box;
+
+use arm_string_ops::*;
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+const SIZES: [usize; 4] = [64, 1024, 65536, 1 << 20];
+
+// Mixed text: mostly ASCII with 2-, 3- and 4-byte characters
+fn text(len: usize) -> Vec<u8> {
+    let pattern = "The quick brown fox jumps over the lazy dog. caf\u{e9} \u{4e16}\u{754c} \u{1F600} ";
+    pattern.bytes().cycle().take(len).collect::<Vec<u8>>()
+}
+
+// The longest valid prefix, so both sides see valid input
+fn valid_text(len: usize) -> Vec<u8> {
+    let mut bytes = text(len);
+    match std::str::from_utf8(&bytes) {
+        Ok(_) => {}
+        Err(e) => bytes.truncate(e.valid_up_to()),
+    }
+    bytes
+}
+
+fn bench_validate(c: &mut Criterion) {
+    let mut group = c.benchmark_group("from_utf8");
+    for size in SIZES {
+        let bytes = valid_text(size);
+        group.throughput(Throughput::Bytes(bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::new("neon", size), &bytes, |b, bytes| {
+            b.iter(|| from_utf8(black_box(bytes)).is_ok())
+        });
+        group.bench_with_input(BenchmarkId::new("std", size), &bytes, |b, bytes| {
+            b.iter(|| std::str::from_utf8(black_box(bytes)).is_ok())
+        });
+    }
+    group.finish();
+}
+
+fn bench_count(c: &mut Criterion) {
+    let mut group = c.benchmark_group("char_count");
+    for size in SIZES {
+        let bytes = valid_text(size);
+        let s = std::str::from_utf8(&bytes).unwrap();
+        group.throughput(Throughput::Bytes(bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::new("neon", size), &bytes, |b, bytes| {
+            b.iter(|| char_count(black_box(bytes)))
+        });
+        group.bench_with_input(BenchmarkId::new("std", size), s, |b, s| {
+            b.iter(|| black_box(s).chars().count())
+        });
+    }
+    group.finish();
+}
+
+fn bench_case(c: &mut Criterion) {
+    let mut group = c.benchmark_group("to_upper");
+    for size in SIZES {
+        let mut bytes = text(size);
+        group.throughput(Throughput::Bytes(size as u64));
+        group.bench_function(BenchmarkId::new("neon", size), |b| {
+            b.iter(|| to_upper(black_box(&mut bytes[..])))
+        });
+        group.bench_function(BenchmarkId::new("std", size), |b| {
+            b.iter(|| black_box(&mut bytes[..]).make_ascii_uppercase())
+        });
+    }
+    group.finish();
+}
+
+fn bench_stream(c: &mut Criterion) {
+    // 1 MiB arriving as 1500-byte packets
+    let bytes = valid_text(1 << 20);
+    let mut group = c.benchmark_group("stream");
+    group.throughput(Throughput::Bytes(bytes.len() as u64));
+    group.bench_function("neon_1500", |b| {
+        b.iter(|| {
+            let mut stream = Utf8Stream::new();
+            for chunk in black_box(&bytes).chunks(1500) {
+                stream.update(chunk);
+            }
+            stream.finish().is_ok()
+        })
+    });
+    group.finish();
+}
+
+fn bench_column(c: &mut Criterion) {
+    // 10000 short fields, the case the batch kernels pack into full vectors
+    let bytes = valid_text(1 << 20);
+    let s = std::str::from_utf8(&bytes).unwrap();
+    let mut offsets = vec![0i32];
+    let mut end = 0usize;
+    for (i, _) in s.char_indices().skip(1).step_by(13).take(10000) {
+        end = i;
+        offsets.push(end as i32);
+    }
+    let data = &bytes[..end];
+    let mut group = c.benchmark_group("column");
+    group.throughput(Throughput::Elements((offsets.len() - 1) as u64));
+    group.bench_function("neon_validate", |b| {
+        b.iter(|| utf8_validate_column(black_box(data), black_box(&offsets)))
+    });
+    group.bench_function("std_validate", |b| {
+        b.iter(|| {
+            offsets
+                .windows(2)
+                .filter(|w| std::str::from_utf8(&data[w[0] as usize..w[1] as usize]).is_ok())
+                .count()
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_validate, bench_count, bench_case, bench_stream, bench_column);
+criterion_main!(benches);
@@ -0,0 +1,85 @@
+//! Builds `libarm_string_ops.a` with the repository Makefile and links it
+//! statically.
+//!
+//! The library is built into `OUT_DIR`, so the source tree stays clean. When
+//! cross-compiling, the GNU tools are taken from `ARM_STRING_OPS_CROSS`
+//! (default `aarch64-linux-gnu-`). Set `ARM_STRING_OPS_LIB_DIR` to link an
+//! already built library instead, e.g. an `make instrumented` build.
+//!
+//! The size thresholds come from the header `make calibrate` writes to the
+//! repository's `build/tuning/`, or from `src/tuning.h` when there is none;
+//! `ARM_STRING_OPS_TUNING_DIR` names another directory (absolute) holding a
+//! `tuning.h`.
+
+use std::env;
+use std::path::{Path, PathBuf};
+use std::process::Command;
+
+fn main() {
+    println!("cargo:rerun-if-env-changed=ARM_STRING_OPS_LIB_DIR");
+    println!("cargo:rerun-if-env-changed=ARM_STRING_OPS_CROSS");
+    println!("cargo:rerun-if-env-changed=ARM_STRING_OPS_TUNING_DIR");
+
+    let lib_dir = match env::var_os("ARM_STRING_OPS_LIB_DIR") {
+        Some(dir) => PathBuf::from(dir),
+        None => build_library(),
+    };
+    println!("cargo:rustc-link-search=native={}", lib_dir.display());
+    println!("cargo:rustc-link-lib=static=arm_string_ops");
+    println!("cargo:rustc-link-lib=pthread");
+}
+
+fn build_library() -> PathBuf {
+    let target_arch = env::var("CARGO_CFG_TARGET_ARCH").unwrap();
+    if target_arch != "aarch64" {
+        panic!(
+            "arm_string_ops is ARMv8 assembly and needs an aarch64 target (building for {}); \
+             set ARM_STRING_OPS_LIB_DIR to link a prebuilt library",
+            target_arch
+        );
+    }
+
+    let manifest_dir = PathBuf::from(env::var("CARGO_MANIFEST_DIR").unwrap());
+    let root = manifest_dir.join("../..");
+    for dir in ["src", "include"] {
+        println!("cargo:rerun-if-changed={}", root.join(dir).display());
+    }
+    println!("cargo:rerun-if-changed={}", root.join("Makefile").display());
+
+    // BUILD_DIR would otherwise move TUNING_DIR into OUT_DIR, away from the
+    // calibrated header. A missing header makes cargo rerun this script on
+    // every build, which costs one make that has nothing to do
+    let tuning_dir = env::var_os("ARM_STRING_OPS_TUNING_DIR")
+        .map(PathBuf::from)
+        .unwrap_or_else(|| root.join("build/tuning"));
+    println!("cargo:rerun-if-changed={}", tuning_dir.join("tuning.h").display());
+
+    let build_dir = PathBuf::from(env::var("OUT_DIR").unwrap()).join("build");
+    let lib = build_dir.join("libarm_string_ops.a");
+
+    let mut make = Command::new(env::var("MAKE").unwrap_or_else(|_| "make".into()));
+    make.arg("-C")
+        .arg(&root)
+        .arg(format!("BUILD_DIR={}", build_dir.display()))
+        .arg(format!("TUNING_DIR={}", tuning_dir.display()));
+    if env::var("HOST").unwrap() != env::var("TARGET").unwrap() {
+        let prefix = env::var("ARM_STRING_OPS_CROSS").unwrap_or_else(|_| "aarch64-linux-gnu-".into());
+        for (var, tool) in [("CC", "gcc"), ("AS", "as"), ("AR", "ar")] {
+            make.arg(format!("{}={}{}", var, prefix, tool));
+        }
+    }
+    if let Ok(jobs) = env::var("NUM_JOBS") {
+        make.arg(format!("-j{}", jobs));
+    }
+    run(make.arg(&lib), &root);
+    build_dir
+}
+
+fn run(cmd: &mut Command, root: &Path) {
+    let status = cmd
+        .status()
+        .unwrap_or_else(|e| panic!("failed to run make in {}: {}", root.display(), e));
+    if !status.success() {
+        panic!("building libarm_string_ops.a failed ({})", status);
+    }
+}
@@ -7,6 +7,16 @@
 //! 
 //! - **Case Conversion**: Fast ASCII case conversion using SIMD
 //! - **UTF-8 Operations**: Validation and character counting
+//! - **Streaming and Batches**: Chunked validation, string arrays and Arrow-style columns
+//! - **Transcoding**: Validating UTF-8 ↔ UTF-16 and UTF-8 → UTF-32 conversion
+//! 
+//! Everything works on the caller's bytes: `&[u8]` input is validated by the
+//! library itself (there is no need to go through `std::str::from_utf8`
+//! first), and nothing is copied into `CString`s or other temporaries. The
+//! `&str`/`String` functions are thin wrappers over the byte versions.
+//! 
+//! `build.rs` builds and statically links `libarm_string_ops.a`; see
+//! `docs/BUILDING.md` for the options.
 //! 
 //! # Example
 //! 
@@ -16,35 +26,72 @@
 //! let mut text = "Hello World".to_string();
 //! to_upper_inplace(&mut text);
 //! assert_eq!(text, "HELLO WORLD");
+//! 
+//! let packet: &[u8] = b"caf\xc3\xa9";
+//! assert_eq!(from_utf8(packet), Ok("caf\u{e9}"));
 //! ```
 
-use std::ffi::{CStr, CString};
 use std::os::raw::{c_char, c_int};
-use std::ptr;
 
 /// Error types for string operations
 #[derive(Debug, Clone, PartialEq)]
 pub enum StringOpsError {
     /// Invalid UTF-8 sequence
     InvalidUtf8,
+    /// Invalid UTF-8 sequence starting at the given byte offset
+    InvalidUtf8At(usize),
+    /// Unpaired UTF-16 surrogate at the given code unit offset
+    InvalidUtf16At(usize),
 }
 
 impl std::fmt::Display for StringOpsError {
     fn fmt(&self, f: &mut std::fmt::Formatter) -> std::fmt::Result {
         match self {
             StringOpsError::InvalidUtf8 => write!(f, "Invalid UTF-8 sequence"),
+            StringOpsError::InvalidUtf8At(offset) => {
+                write!(f, "Invalid UTF-8 sequence at byte {}", offset)
+            }
+            StringOpsError::InvalidUtf16At(offset) => {
+                write!(f, "Unpaired UTF-16 surrogate at code unit {}", offset)
+            }
         }
     }
 }
 
 impl std::error::Error for StringOpsError {}
 
+/// State of `neon_utf8_stream_*`, laid out as `neon_utf8_stream_t`
+#[repr(C)]
+#[derive(Clone, Copy)]
+struct RawUtf8Stream {
+    prev: [u8; 16],
+    pending: [u8; 64],
+    pending_len: u32,
+    error: u32,
+}
+
 // Raw FFI declarations
 extern "C" {
     fn neon_to_upper(str: *mut c_char, len: usize);
     fn neon_to_lower(str: *mut c_char, len: usize);
+    fn neon_to_upper_copy(dst: *mut c_char, src: *const c_char, len: usize);
+    fn neon_to_lower_copy(dst: *mut c_char, src: *const c_char, len: usize);
+    fn neon_to_upper_batch(strs: *const *mut c_char, lens: *const usize, n: usize);
+    fn neon_to_lower_batch(strs: *const *mut c_char, lens: *const usize, n: usize);
+    fn neon_to_upper_column(data: *mut c_char, offsets: *const i32, n: usize);
+    fn neon_to_lower_column(data: *mut c_char, offsets: *const i32, n: usize);
     fn neon_utf8_validate(str: *const c_char, len: usize) -> c_int;
+    fn neon_utf8_validate_ex(str: *const c_char, len: usize, error_offset: *mut usize) -> c_int;
     fn neon_utf8_count_chars(str: *const c_char, len: usize) -> usize;
+    fn neon_is_ascii(str: *const c_char, len: usize) -> c_int;
+    fn neon_utf8_validate_batch(strs: *const *const c_char, lens: *const usize, n: usize, valid_bits: *mut u8);
+    fn neon_utf8_validate_column(data: *const c_char, offsets: *const i32, n: usize, valid_bits: *mut u8);
+    fn neon_utf8_stream_init(state: *mut RawUtf8Stream);
+    fn neon_utf8_stream_update(state: *mut RawUtf8Stream, data: *const c_char, len: usize) -> c_int;
+    fn neon_utf8_stream_finish(state: *mut RawUtf8Stream) -> c_int;
+    fn neon_utf8_to_utf16(src: *const c_char, len: usize, dst: *mut u16, out_len: *mut usize) -> c_int;
+    fn neon_utf8_to_utf32(src: *const c_char, len: usize, dst: *mut u32, out_len: *mut usize) -> c_int;
+    fn neon_utf16_to_utf8(src: *const u16, len: usize, dst: *mut c_char, out_len: *mut usize) -> c_int;
 }
 
 /// Convert ASCII characters to uppercase in-place
@@ -54,15 +101,14 @@ extern "C" {
 /// # Example
 /// 
 /// ```rust
+/// # use arm_string_ops::*;
 /// let mut text = "Hello World!".to_string();
 /// to_upper_inplace(&mut text);
 /// assert_eq!(text, "HELLO WORLD!");
 /// ```
 pub fn to_upper_inplace(text: &mut String) {
-    unsafe {
-        let bytes = text.as_mut_vec();
-        neon_to_upper(bytes.as_mut_ptr() as *mut c_char, bytes.len());
-    }
+    // ASCII case conversion keeps UTF-8 valid
+    to_upper(unsafe { text.as_mut_vec() });
 }
 
 /// Convert ASCII characters to lowercase in-place
@@ -72,17 +118,73 @@ pub fn to_upper_inplace(text: &mut String) {
 /// # Example
 /// 
 /// ```rust
+/// # use arm_string_ops::*;
 /// let mut text = "HELLO WORLD!".to_string();
 /// to_lower_inplace(&mut text);
 /// assert_eq!(text, "hello world!");
 /// ```
 pub fn to_lower_inplace(text: &mut String) {
+    to_lower(unsafe { text.as_mut_vec() });
+}
+
+/// Convert ASCII letters of a byte slice to uppercase in-place
+/// 
+/// The bytes do not have to be UTF-8; bytes >= 0x80 are left unchanged.
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// let mut header = *b"content-type";
+/// to_upper(&mut header);
+/// assert_eq!(&header, b"CONTENT-TYPE");
+/// ```
+pub fn to_upper(bytes: &mut [u8]) {
+    unsafe {
+        neon_to_upper(bytes.as_mut_ptr() as *mut c_char, bytes.len());
+    }
+}
+
+/// Convert ASCII letters of a byte slice to lowercase in-place
+pub fn to_lower(bytes: &mut [u8]) {
     unsafe {
-        let bytes = text.as_mut_vec();
         neon_to_lower(bytes.as_mut_ptr() as *mut c_char, bytes.len());
     }
 }
 
+/// Write the uppercased bytes of `src` to the start of `dst` in one pass
+/// 
+/// # Panics
+/// 
+/// If `dst` is shorter than `src`.
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// let mut out = [0u8; 5];
+/// to_upper_into(b"hello", &mut out);
+/// assert_eq!(&out, b"HELLO");
+/// ```
+pub fn to_upper_into(src: &[u8], dst: &mut [u8]) {
+    let dst = &mut dst[..src.len()];
+    unsafe {
+        neon_to_upper_copy(dst.as_mut_ptr() as *mut c_char, src.as_ptr() as *const c_char, src.len());
+    }
+}
+
+/// Write the lowercased bytes of `src` to the start of `dst` in one pass
+/// 
+/// # Panics
+/// 
+/// If `dst` is shorter than `src`.
+pub fn to_lower_into(src: &[u8], dst: &mut [u8]) {
+    let dst = &mut dst[..src.len()];
+    unsafe {
+        neon_to_lower_copy(dst.as_mut_ptr() as *mut c_char, src.as_ptr() as *const c_char, src.len());
+    }
+}
+
 
 /// Validate UTF-8 encoding
 /// 
@@ -91,6 +193,7 @@ pub fn to_lower_inplace(text: &mut String) {
 /// # Example
 /// 
 /// ```rust
+/// # use arm_string_ops::*;
 /// assert!(utf8_validate("Hello 世界").is_ok());
 /// assert!(utf8_validate("Hello World").is_ok());
 /// ```
@@ -116,6 +219,7 @@ pub fn utf8_validate(text: &str) -> Result<(), StringOpsError> {
 /// # Example
 /// 
 /// ```rust
+/// # use arm_string_ops::*;
 /// assert_eq!(utf8_char_count("Hello"), 5);
 /// assert_eq!(utf8_char_count("café"), 4); // é counts as 1 character
 /// assert_eq!(utf8_char_count("世界"), 2);
@@ -129,6 +233,283 @@ pub fn utf8_char_count(text: &str) -> usize {
     }
 }
 
+/// Validate UTF-8 bytes and view them as a `&str`, without copying
+/// 
+/// The drop-in replacement for `std::str::from_utf8` on network or file
+/// data: the bytes are checked once, by the SIMD validator. The error
+/// carries the byte offset of the first invalid sequence.
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// assert_eq!(from_utf8(b"Hello \xe4\xb8\x96\xe7\x95\x8c"), Ok("Hello 世界"));
+/// assert_eq!(from_utf8(b"ab\xc3("), Err(StringOpsError::InvalidUtf8At(2)));
+/// ```
+pub fn from_utf8(bytes: &[u8]) -> Result<&str, StringOpsError> {
+    let mut offset = 0usize;
+    unsafe {
+        let result = neon_utf8_validate_ex(bytes.as_ptr() as *const c_char, bytes.len(), &mut offset);
+        if result == 1 {
+            Ok(std::str::from_utf8_unchecked(bytes))
+        } else {
+            Err(StringOpsError::InvalidUtf8At(offset))
+        }
+    }
+}
+
+/// Mutable version of [`from_utf8`]
+pub fn from_utf8_mut(bytes: &mut [u8]) -> Result<&mut str, StringOpsError> {
+    from_utf8(bytes)?;
+    Ok(unsafe { std::str::from_utf8_unchecked_mut(bytes) })
+}
+
+/// Check UTF-8 bytes; faster than [`from_utf8`] when the error position is not needed
+pub fn is_valid_utf8(bytes: &[u8]) -> bool {
+    unsafe { neon_utf8_validate(bytes.as_ptr() as *const c_char, bytes.len()) == 1 }
+}
+
+/// Check that every byte is 7-bit ASCII
+pub fn is_ascii(bytes: &[u8]) -> bool {
+    unsafe { neon_is_ascii(bytes.as_ptr() as *const c_char, bytes.len()) == 1 }
+}
+
+/// Count the characters of UTF-8 bytes: the bytes that are not
+/// continuation bytes, which is exact when the input is valid
+pub fn char_count(bytes: &[u8]) -> usize {
+    unsafe { neon_utf8_count_chars(bytes.as_ptr() as *const c_char, bytes.len()) }
+}
+
+/// Incremental UTF-8 validation of data that arrives in chunks
+/// 
+/// Multibyte characters may be split between chunks. The state is a plain
+/// value (no allocation) that can live inside a connection struct.
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// let mut stream = Utf8Stream::new();
+/// stream.update(b"caf\xc3");          // 'é' split across two reads
+/// stream.update(b"\xa9 au lait");
+/// assert!(stream.finish().is_ok());
+/// ```
+#[derive(Clone)]
+pub struct Utf8Stream {
+    state: RawUtf8Stream,
+}
+
+impl Utf8Stream {
+    pub fn new() -> Self {
+        let mut state = RawUtf8Stream { prev: [0; 16], pending: [0; 64], pending_len: 0, error: 0 };
+        unsafe {
+            neon_utf8_stream_init(&mut state);
+        }
+        Utf8Stream { state }
+    }
+
+    /// Feed the next chunk; returns `false` once an error has been seen
+    pub fn update(&mut self, chunk: &[u8]) -> bool {
+        unsafe { neon_utf8_stream_update(&mut self.state, chunk.as_ptr() as *const c_char, chunk.len()) == 1 }
+    }
+
+    /// End of input: fails if any chunk was invalid or the data ends inside a character
+    pub fn finish(mut self) -> Result<(), StringOpsError> {
+        if unsafe { neon_utf8_stream_finish(&mut self.state) } == 1 {
+            Ok(())
+        } else {
+            Err(StringOpsError::InvalidUtf8)
+        }
+    }
+}
+
+impl Default for Utf8Stream {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Validity of each string in the Arrow bitmap layout: bit `i % 8` of byte
+/// `i / 8` is set if string `i` is valid UTF-8; bits past the last string are 0
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// let fields: [&[u8]; 3] = [b"GET", b"\xff", "\u{e9}t\u{e9}".as_bytes()];
+/// assert_eq!(utf8_validate_batch(&fields), vec![0b101]);
+/// ```
+pub fn utf8_validate_batch(strs: &[&[u8]]) -> Vec<u8> {
+    let ptrs: Vec<*const c_char> = strs.iter().map(|s| s.as_ptr() as *const c_char).collect();
+    let lens: Vec<usize> = strs.iter().map(|s| s.len()).collect();
+    let mut bits = vec![0u8; (strs.len() + 7) / 8];
+    unsafe {
+        neon_utf8_validate_batch(ptrs.as_ptr(), lens.as_ptr(), strs.len(), bits.as_mut_ptr());
+    }
+    bits
+}
+
+/// Per-string validity of an Arrow-style string column: string `i` is
+/// `data[offsets[i]..offsets[i + 1]]`. Same bitmap layout as [`utf8_validate_batch`]
+/// 
+/// # Panics
+/// 
+/// If the offsets decrease, are negative or point past the end of `data`.
+pub fn utf8_validate_column(data: &[u8], offsets: &[i32]) -> Vec<u8> {
+    let n = column_len(data, offsets);
+    let mut bits = vec![0u8; (n + 7) / 8];
+    if n > 0 {
+        unsafe {
+            neon_utf8_validate_column(data.as_ptr() as *const c_char, offsets.as_ptr(), n, bits.as_mut_ptr());
+        }
+    }
+    bits
+}
+
+/// In-place ASCII uppercasing of many strings in one call
+pub fn to_upper_batch(strs: &mut [&mut [u8]]) {
+    let (ptrs, lens) = batch_parts(strs);
+    unsafe {
+        neon_to_upper_batch(ptrs.as_ptr(), lens.as_ptr(), strs.len());
+    }
+}
+
+/// In-place ASCII lowercasing of many strings in one call
+pub fn to_lower_batch(strs: &mut [&mut [u8]]) {
+    let (ptrs, lens) = batch_parts(strs);
+    unsafe {
+        neon_to_lower_batch(ptrs.as_ptr(), lens.as_ptr(), strs.len());
+    }
+}
+
+/// In-place ASCII uppercasing of the strings of a column (see [`utf8_validate_column`])
+pub fn to_upper_column(data: &mut [u8], offsets: &[i32]) {
+    let n = column_len(data, offsets);
+    if n > 0 {
+        unsafe {
+            neon_to_upper_column(data.as_mut_ptr() as *mut c_char, offsets.as_ptr(), n);
+        }
+    }
+}
+
+/// In-place ASCII lowercasing of the strings of a column (see [`utf8_validate_column`])
+pub fn to_lower_column(data: &mut [u8], offsets: &[i32]) {
+    let n = column_len(data, offsets);
+    if n > 0 {
+        unsafe {
+            neon_to_lower_column(data.as_mut_ptr() as *mut c_char, offsets.as_ptr(), n);
+        }
+    }
+}
+
+// Pointer and length arrays for the batch entry points
+fn batch_parts(strs: &mut [&mut [u8]]) -> (Vec<*mut c_char>, Vec<usize>) {
+    let ptrs = strs.iter_mut().map(|s| s.as_mut_ptr() as *mut c_char).collect();
+    let lens = strs.iter().map(|s| s.len()).collect();
+    (ptrs, lens)
+}
+
+// Number of strings in a column; checks the offsets the kernels trust
+fn column_len(data: &[u8], offsets: &[i32]) -> usize {
+    let mut prev = 0i32;
+    for (i, &off) in offsets.iter().enumerate() {
+        assert!(off >= 0 && (i == 0 || off >= prev), "column offsets must be non-negative and non-decreasing");
+        prev = off;
+    }
+    assert!(prev as usize <= data.len(), "column offset {} past the end of {} data bytes", prev, data.len());
+    offsets.len().saturating_sub(1)
+}
+
+/// Convert UTF-8 bytes to UTF-16, validating them in the same pass
+/// 
+/// On invalid input the error carries the byte offset of the first invalid
+/// sequence (the same offset `neon_utf8_validate_ex` reports).
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// assert_eq!(utf8_to_utf16("h\u{e9}\u{1F600}".as_bytes()).unwrap(), vec![0x68, 0xE9, 0xD83D, 0xDE00]);
+/// assert_eq!(utf8_to_utf16(b"ab\xff"), Err(StringOpsError::InvalidUtf8At(2)));
+/// ```
+pub fn utf8_to_utf16(bytes: &[u8]) -> Result<Vec<u16>, StringOpsError> {
+    let mut out: Vec<u16> = Vec::with_capacity(bytes.len());
+    let mut out_len = 0usize;
+    unsafe {
+        let result = neon_utf8_to_utf16(
+            bytes.as_ptr() as *const c_char,
+            bytes.len(),
+            out.as_mut_ptr(),
+            &mut out_len
+        );
+        
+        if result == 1 {
+            out.set_len(out_len);
+            Ok(out)
+        } else {
+            Err(StringOpsError::InvalidUtf8At(out_len))
+        }
+    }
+}
+
+/// Convert UTF-8 bytes to UTF-32 code points, validating them in the same pass
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// assert_eq!(utf8_to_utf32("h\u{e9}\u{1F600}".as_bytes()).unwrap(), vec![0x68, 0xE9, 0x1F600]);
+/// ```
+pub fn utf8_to_utf32(bytes: &[u8]) -> Result<Vec<u32>, StringOpsError> {
+    let mut out: Vec<u32> = Vec::with_capacity(bytes.len());
+    let mut out_len = 0usize;
+    unsafe {
+        let result = neon_utf8_to_utf32(
+            bytes.as_ptr() as *const c_char,
+            bytes.len(),
+            out.as_mut_ptr(),
+            &mut out_len
+        );
+        
+        if result == 1 {
+            out.set_len(out_len);
+            Ok(out)
+        } else {
+            Err(StringOpsError::InvalidUtf8At(out_len))
+        }
+    }
+}
+
+/// Convert UTF-16 code units to a `String`, rejecting unpaired surrogates
+/// 
+/// # Example
+/// 
+/// ```rust
+/// # use arm_string_ops::*;
+/// assert_eq!(utf16_to_utf8(&[0x68, 0xE9, 0xD83D, 0xDE00]).unwrap(), "h\u{e9}\u{1F600}");
+/// assert_eq!(utf16_to_utf8(&[0x61, 0xD800]), Err(StringOpsError::InvalidUtf16At(1)));
+/// ```
+pub fn utf16_to_utf8(units: &[u16]) -> Result<String, StringOpsError> {
+    let mut out: Vec<u8> = Vec::with_capacity(units.len() * 3);
+    let mut out_len = 0usize;
+    unsafe {
+        let result = neon_utf16_to_utf8(
+            units.as_ptr(),
+            units.len(),
+            out.as_mut_ptr() as *mut c_char,
+            &mut out_len
+        );
+        
+        if result == 1 {
+            out.set_len(out_len);
+            // The kernel only emits well-formed UTF-8
+            Ok(String::from_utf8_unchecked(out))
+        } else {
+            Err(StringOpsError::InvalidUtf16At(out_len))
+        }
+    }
+}
+
 
 /// Trait for string slice extensions
 pub trait StringOpsExt {
@@ -149,6 +530,16 @@ impl StringOpsExt for str {
     }
 }
 
+impl StringOpsExt for [u8] {
+    fn validate_utf8(&self) -> Result<(), StringOpsError> {
+        from_utf8(self).map(|_| ())
+    }
+    
+    fn char_count_utf8(&self) -> usize {
+        char_count(self)
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -170,6 +561,102 @@ mod tests {
         
         assert_eq!(utf8_char_count("Hello"), 5);
         assert_eq!(utf8_char_count("Hello World"), 11);
+        assert_eq!(utf8_char_count("café"), 4);
+        assert_eq!(utf8_char_count("世界 😀"), 4);
+    }
+
+    #[test]
+    fn test_transcoding() {
+        let text = "caf\u{e9} \u{4e16} \u{1F600}";
+        let wide = utf8_to_utf16(text.as_bytes()).unwrap();
+        assert_eq!(wide, text.encode_utf16().collect::<Vec<u16>>());
+        assert_eq!(utf16_to_utf8(&wide).unwrap(), text);
+        assert_eq!(utf8_to_utf32(text.as_bytes()).unwrap(),
+                   text.chars().map(|c| c as u32).collect::<Vec<u32>>());
+        
+        assert_eq!(utf8_to_utf16(b"abc\xe2\x82"), Err(StringOpsError::InvalidUtf8At(3)));
+        assert_eq!(utf16_to_utf8(&[0xDC00]), Err(StringOpsError::InvalidUtf16At(0)));
+        assert_eq!(utf8_to_utf16(b"").unwrap(), Vec::<u16>::new());
+    }
+
+    #[test]
+    fn test_byte_slices() {
+        let mut header = *b"Content-Type: text/html; charset=\xff";
+        to_lower(&mut header);
+        assert_eq!(&header, b"content-type: text/html; charset=\xff");
+        to_upper(&mut header[..12]);
+        assert_eq!(&header[..14], b"CONTENT-TYPE: ");
+        
+        let mut out = [0u8; 40];
+        to_upper_into(b"abc", &mut out);
+        assert_eq!(&out[..4], b"ABC\0");
+        to_lower_into(b"XYZ", &mut out[1..]);
+        assert_eq!(&out[..4], b"Axyz");
+        
+        assert_eq!(from_utf8("h\u{e9}llo w\u{f6}rld".as_bytes()), Ok("h\u{e9}llo w\u{f6}rld"));
+        assert_eq!(from_utf8(b"0123456789abcdef\xe2\x82"), Err(StringOpsError::InvalidUtf8At(16)));
+        let mut owned = b"MIXED".to_vec();
+        from_utf8_mut(&mut owned).unwrap().make_ascii_lowercase();
+        assert_eq!(owned, b"mixed");
+        assert!(is_valid_utf8(b"") && !is_valid_utf8(b"\xc0\x80"));
+        assert!(is_ascii(b"plain") && !is_ascii("\u{e9}".as_bytes()));
+        assert_eq!(char_count("\u{4e16}\u{754c}".as_bytes()), 2);
+        assert!(b"\xed\xa0\x80".validate_utf8().is_err());
+    }
+
+    #[test]
+    #[should_panic]
+    fn test_into_short_destination() {
+        to_upper_into(b"too long", &mut [0u8; 4]);
+    }
+
+    #[test]
+    fn test_stream() {
+        let text = "d\u{e9}j\u{e0} vu \u{4e16}\u{754c} \u{1F600}".repeat(20);
+        for split in [1, 3, 7, 64, 100] {
+            let mut stream = Utf8Stream::new();
+            for chunk in text.as_bytes().chunks(split) {
+                assert!(stream.update(chunk));
+            }
+            assert!(stream.finish().is_ok());
+        }
+        
+        let mut stream = Utf8Stream::default();
+        assert!(stream.update(b"abc\xf0\x9f"));
+        assert!(stream.finish().is_err());
+        let mut stream = Utf8Stream::new();
+        assert!(!stream.update(b"\x80"));
+        assert!(!stream.update(b"ok"));
+    }
+
+    #[test]
+    fn test_batch_and_column() {
+        let fields: Vec<&[u8]> = vec![b"ok", b"\xff", b"", "\u{e9}".as_bytes(), b"\xe2\x82",
+                                      b"a", b"b", b"c", b"\xc3"];
+        assert_eq!(utf8_validate_batch(&fields), vec![0b1110_1101, 0]);
+        assert!(utf8_validate_batch(&[]).is_empty());
+        
+        let mut a = *b"alpha";
+        let mut b = *b"Beta-2";
+        to_upper_batch(&mut [&mut a[..], &mut b[..]]);
+        assert_eq!((&a, &b), (b"ALPHA", b"BETA-2"));
+        to_lower_batch(&mut [&mut b[..]]);
+        assert_eq!(&b, b"beta-2");
+        
+        let mut data = b"GETPOSTx\xffHEAD".to_vec();
+        let offsets = [0, 3, 7, 9, 13];
+        assert_eq!(utf8_validate_column(&data, &offsets), vec![0b1011]);
+        to_lower_column(&mut data, &offsets[..3]);
+        assert_eq!(&data, b"getpostx\xffHEAD");
+        to_upper_column(&mut data, &offsets);
+        assert_eq!(&data, b"GETPOSTX\xffHEAD");
+        assert!(utf8_validate_column(&data, &[]).is_empty());
+    }
+
+    #[test]
+    #[should_panic]
+    fn test_column_offsets_checked() {
+        utf8_validate_column(b"abc", &[0, 2, 1]);
     }
 
     #[test]
@@ -12,14 +12,254 @@ extern "C" {
 // High-performance string processing using SIMD instructions
 
 // Case conversion operations (ASCII only, non-ASCII bytes unchanged)
-// These functions modify the input string in-place for maximum performance
+// These functions modify the input string in-place for maximum performance;
+// blocks that are already in the target case are not written back
 void neon_to_upper(char* str, size_t len);
 void neon_to_lower(char* str, size_t len);
 
+// Out-of-place case conversion: read src, write the converted bytes to dst
+// in a single pass (no separate copy). dst and src must be identical or
+// must not overlap
+void neon_to_upper_copy(char* dst, const char* src, size_t len);
+void neon_to_lower_copy(char* dst, const char* src, size_t len);
+
+// Batch case conversion, in-place: n separate strings, or an Arrow-style
+// string column (n + 1 int32 offsets into one data buffer)
+void neon_to_upper_batch(char* const* strs, const size_t* lens, size_t n);
+void neon_to_lower_batch(char* const* strs, const size_t* lens, size_t n);
+void neon_to_upper_column(char* data, const int32_t* offsets, size_t n);
+void neon_to_lower_column(char* data, const int32_t* offsets, size_t n);
+
+// Case-insensitive operations: ASCII case is folded in registers, nothing
+// is written back. neon_ascii_casecmp compares exactly len bytes (NUL is an
+// ordinary byte) and returns <0, 0 or >0 like memcmp on the lowercased bytes
+int neon_ascii_casecmp(const char* a, const char* b, size_t len);
+// CRC32C of the lowercased bytes; pass 0 as seed, or a previous result to
+// continue hashing (hash(a + b) == hash(b, hash(a))). Needs the CRC32 extension
+uint32_t neon_hash_lower(const char* str, size_t len, uint32_t seed);
+
+// Key table: up to 64 keys of up to 64 bytes, lowercased once by
+// neon_key_table_init, that neon_key_table_find matches one input against
+// (e.g. HTTP header names). Lookups fold the input in registers and compare
+// it only with the keys of the same length, 64 bytes at a time
+#define NEON_KEY_TABLE_MAX_KEYS 64
+#define NEON_KEY_TABLE_MAX_LEN  64
+typedef struct {
+    uint8_t lens[NEON_KEY_TABLE_MAX_KEYS];       // 0xFF for unused slots
+    uint8_t keys[NEON_KEY_TABLE_MAX_KEYS][NEON_KEY_TABLE_MAX_LEN];  // Lowercased, zero padded
+} neon_key_table_t;
+// Returns 1, or 0 (table unchanged) if n or a key length is above the limits
+int neon_key_table_init(neon_key_table_t* table, const char* const* keys, const size_t* lens, size_t n);
+// Returns the index of the first key equal to key ignoring ASCII case, or -1
+int neon_key_table_find(const neon_key_table_t* table, const char* key, size_t len);
+
+// Whitespace operations (C locale isspace: space, \t \n \v \f \r). Same
+// in-place and out-of-place conventions as the case functions; all of them
+// return the new length. The in-place trims move the text to the front
+size_t neon_trim(char* str, size_t len);
+size_t neon_trim_copy(char* dst, const char* src, size_t len);
+// Trim and lowercase (ASCII) in one pass, e.g. to normalize keys
+size_t neon_trim_lower(char* str, size_t len);
+size_t neon_trim_lower_copy(char* dst, const char* src, size_t len);
+// Replace every run of whitespace with a single space
+size_t neon_collapse_whitespace(char* str, size_t len);
+size_t neon_collapse_whitespace_copy(char* dst, const char* src, size_t len);
+// Remove control characters: 0x00-0x1F except whitespace, and 0x7F
+size_t neon_strip_control(char* str, size_t len);
+size_t neon_strip_control_copy(char* dst, const char* src, size_t len);
+
+// Unicode case conversion for UTF-8 text (Unicode simple case mapping:
+// Latin, Greek, Cyrillic, Armenian, ...). Latin-1, Latin Extended-A, Greek and
+// Cyrillic are vectorized. Returns the number of bytes written, which is at
+// most len: mappings that would lengthen the encoding are not applied.
+// dst must hold len bytes and may equal src; invalid bytes are copied as-is
+size_t neon_utf8_to_upper(char* dst, const char* src, size_t len);
+size_t neon_utf8_to_lower(char* dst, const char* src, size_t len);
+
+// Search operations: return the offset of the first match, or len if there
+// is none (memchr/memmem semantics with offsets instead of pointers)
+size_t neon_memchr(const char* str, size_t len, int c);
+size_t neon_memchr2(const char* str, size_t len, int c1, int c2);           // first c1 or c2
+size_t neon_memchr3(const char* str, size_t len, int c1, int c2, int c3);   // first c1, c2 or c3
+// Substring search; an empty needle matches at offset 0
+size_t neon_find(const char* haystack, size_t len, const char* needle, size_t needle_len);
+// Substring search ignoring ASCII case (both sides folded in registers)
+size_t neon_find_nocase(const char* haystack, size_t len, const char* needle, size_t needle_len);
+
 // UTF-8 operations  
 // Fast validation and character counting with SIMD acceleration
 int neon_utf8_validate(const char* str, size_t len);    // returns 1 if valid, 0 if invalid
 size_t neon_utf8_count_chars(const char* str, size_t len);  // returns Unicode character count
+int neon_is_ascii(const char* str, size_t len);         // returns 1 if every byte is < 0x80
+
+// Single-pass validation and character counting (reads the buffer once)
+// Returns 1 if valid, 0 if invalid; *out_chars (may be NULL) receives the
+// character count, which is only meaningful when the input is valid
+int neon_utf8_validate_count(const char* str, size_t len, size_t* out_chars);
+
+// Validation with error position: returns 1 if valid, 0 if invalid
+// *error_offset (may be NULL) receives the byte offset of the first invalid
+// sequence, or len when the input is valid
+int neon_utf8_validate_ex(const char* str, size_t len, size_t* error_offset);
+
+// Lossy repair: copy src to dst with every maximal invalid subpart replaced by
+// U+FFFD (EF BF BD), the WHATWG/Python "replace" behaviour. Valid blocks are
+// copied through; only blocks with errors go through the scalar decoder.
+// dst needs room for 3 * len bytes and must not overlap src
+// Returns the number of bytes written (len when src is valid)
+size_t neon_utf8_sanitize(char* dst, const char* src, size_t len);
+
+// Batch validation: bit i % 8 of valid_bits[i / 8] is set if string i is
+// valid UTF-8 (Arrow validity bitmap layout, (n + 7) / 8 bytes, bits past n
+// are 0). Short strings are packed together into full vectors
+void neon_utf8_validate_batch(const char* const* strs, const size_t* lens, size_t n,
+                              uint8_t* valid_bits);
+void neon_utf8_validate_column(const char* data, const int32_t* offsets, size_t n,
+                               uint8_t* valid_bits);
+
+// Streaming validation for input that arrives in chunks (e.g. socket reads)
+// Multibyte sequences may be split across chunks; the state keeps the
+// carried block and up to 63 pending bytes between calls. Treat as opaque.
+typedef struct {
+    uint8_t  prev[16];      // Last 16 bytes of the previously checked block
+    uint8_t  pending[64];   // Bytes waiting to fill a 64-byte block
+    uint32_t pending_len;
+    uint32_t error;         // Non-zero once an error has been seen
+} neon_utf8_stream_t;
+
+void neon_utf8_stream_init(neon_utf8_stream_t* state);
+int neon_utf8_stream_update(neon_utf8_stream_t* state, const char* data, size_t len);  // returns 1 if no error so far
+int neon_utf8_stream_finish(neon_utf8_stream_t* state);  // returns 1 if the whole stream is valid
+
+// Delimiter scanning (CSV fields, log lines, ...): a set of up to 16 delimiter
+// bytes is classified with two nibble lookups per byte. Build the set once
+// with neon_delim_set_init (returns 0 if count > 16); treat it as opaque
+typedef struct {
+    uint8_t  nibbles[4][16];  // Low/high nibble tables for high nibbles 0-7 and 8-15
+    uint32_t groups;          // Distinct high nibbles in the set
+} neon_delim_set_t;
+
+int neon_delim_set_init(neon_delim_set_t* set, const char* delims, size_t count);
+// Bit i % 64 of bitmap[i / 64] is set if str[i] is a delimiter; bitmap holds
+// (len + 63) / 64 words. When utf8_valid is not NULL the input is validated
+// in the same pass and *utf8_valid receives 1 (valid) or 0
+void neon_delim_bitmap(const char* str, size_t len, const neon_delim_set_t* set,
+                       uint64_t* bitmap, int* utf8_valid);
+// Stores the offset of every delimiter in increasing order and returns how
+// many there are; offsets needs room for each of them (len must be < 4 GiB)
+size_t neon_delim_offsets(const char* str, size_t len, const neon_delim_set_t* set,
+                          uint32_t* offsets, int* utf8_valid);
+
+// Transcoding with validation (native byte order). Return 1 if the input is
+// valid, with *out_len (may be NULL) = code units written; 0 if invalid, with
+// *out_len = offset of the first invalid sequence in input code units
+// (same offset as neon_utf8_validate_ex). Buffer sizes: utf8_to_utf16 and
+// utf8_to_utf32 need room for len units, utf16_to_utf8 for 3 * len bytes
+int neon_utf8_to_utf16(const char* src, size_t len, uint16_t* dst, size_t* out_len);
+int neon_utf8_to_utf32(const char* src, size_t len, uint32_t* dst, size_t* out_len);
+int neon_utf16_to_utf8(const uint16_t* src, size_t len, char* dst, size_t* out_len);  // unpaired surrogates are errors
+
+// Base64 (RFC 4648 standard alphabet with '=' padding). neon_base64_encode
+// writes 4 * ((len + 2) / 3) characters and returns that count.
+// neon_base64_decode needs room for len / 4 * 3 bytes and returns 1 if src is
+// valid base64, with *out_len (may be NULL) = bytes written; 0 if not, with
+// *out_len = offset of the first invalid character (whitespace included)
+size_t neon_base64_encode(const char* src, size_t len, char* dst);
+int neon_base64_decode(const char* src, size_t len, char* dst, size_t* out_len);
+// Decode and validate the decoded bytes as UTF-8 in the same pass;
+// *utf8_valid (may be NULL) receives 1 if they are valid UTF-8, 0 otherwise
+int neon_base64_decode_utf8(const char* src, size_t len, char* dst, size_t* out_len,
+                            int* utf8_valid);
+
+// Numeric fields. Digits are validated with SIMD range checks; *error_offset
+// (may be NULL) receives the offset of the first rejected byte, or len when
+// the input is valid, as in neon_utf8_validate_ex.
+// neon_parse_u64 returns 1 with *value set if str is one or more decimal
+// digits (leading zeros allowed) whose value fits in 64 bits, 0 otherwise;
+// on overflow the offset is that of the first digit that does not fit
+int neon_parse_u64(const char* str, size_t len, uint64_t* value, size_t* error_offset);
+// Hex digits of either case; dst needs len / 2 bytes. Returns 1 if src is
+// valid hex of even length, 0 otherwise (a trailing unpaired digit is the
+// error at len - 1)
+int neon_hex_decode(const char* src, size_t len, char* dst, size_t* error_offset);
+// Writes 2 * len digits ('A'-'F' when upper is nonzero) and returns that count
+size_t neon_hex_encode(const char* src, size_t len, char* dst, int upper);
+
+// Runtime dispatch: neon_to_upper, neon_to_lower, neon_utf8_validate and
+// neon_utf8_count_chars are bound at load time to SVE kernels when the CPU
+// has SVE with vectors of 256 bits or more, otherwise to the NEON kernels.
+// ARM_STRING_OPS_IMPL=neon or =sve in the environment overrides the choice
+const char* neon_impl_name(void);       // returns "neon" or "sve"
+// The individual kernels (for tests and benchmarks); the _sve ones need SVE
+void neon_to_upper_asimd(char* str, size_t len);
+void neon_to_lower_asimd(char* str, size_t len);
+int neon_utf8_validate_asimd(const char* str, size_t len);
+size_t neon_utf8_count_chars_asimd(const char* str, size_t len);
+void neon_to_upper_sve(char* str, size_t len);
+void neon_to_lower_sve(char* str, size_t len);
+int neon_utf8_validate_sve(const char* str, size_t len);
+size_t neon_utf8_count_chars_sve(const char* str, size_t len);
+
+// Large-buffer mode: case conversion and neon_utf8_validate inputs of at
+// least this many bytes use streaming prefetches (prfm pldl2strm) and
+// non-temporal stores (stnp), so bulk transforms do not evict the working
+// set of other threads. Default 16 MiB (src/tuning.h, see make calibrate);
+// 0 restores the default and SIZE_MAX turns the mode off. Set it before
+// starting threads that use the library
+void neon_set_stream_threshold(size_t bytes);
+size_t neon_get_stream_threshold(void);
+
+// Parallel front end for large buffers (link with -lpthread). The buffer is
+// cut into chunks that worker threads take in turn; results are identical to
+// the single-threaded functions. Inputs shorter than the threshold (or calls
+// that end up with one worker) run on the calling thread. Pass NULL for the
+// defaults; a zero field also selects its default
+typedef void (*neon_parallel_work_fn)(void* arg);
+// Optional executor: run work(arg) on `workers` threads (concurrently or not)
+// and return once every call has returned, with their writes visible
+typedef void (*neon_parallel_spawn_fn)(void* ctx, size_t workers,
+                                       neon_parallel_work_fn work, void* arg);
+typedef struct {
+    size_t threads;          // Worker count, calling thread included (default: online CPUs)
+    size_t chunk_size;       // Bytes per chunk, rounded down to a multiple of 64 (default 512 KiB)
+    size_t threshold;        // Smallest input split across threads (default 4 MiB, src/tuning.h)
+    neon_parallel_spawn_fn spawn;  // NULL: create pthreads for the call
+    void*  spawn_ctx;
+} neon_parallel_config_t;
+
+int neon_utf8_validate_parallel(const char* str, size_t len, const neon_parallel_config_t* cfg);
+size_t neon_utf8_count_chars_parallel(const char* str, size_t len, const neon_parallel_config_t* cfg);
+void neon_to_upper_parallel(char* str, size_t len, const neon_parallel_config_t* cfg);
+void neon_to_lower_parallel(char* str, size_t len, const neon_parallel_config_t* cfg);
+// dst and src must be identical or must not overlap, as for the _copy functions
+void neon_to_upper_copy_parallel(char* dst, const char* src, size_t len, const neon_parallel_config_t* cfg);
+void neon_to_lower_copy_parallel(char* dst, const char* src, size_t len, const neon_parallel_config_t* cfg);
+
+// Hot-path counters, kept per thread by the instrumented build (make
+// instrumented). Bytes are split by the path that handled them: the 64-byte
+// SIMD loops (the whole input for the SVE kernels), the overlapping or
+// zero-padded tail after the loop, and inputs too short for the loop.
+// neon_to_upper/lower and their _copy variants count as case conversion
+typedef struct {
+    uint64_t case_calls;
+    uint64_t case_bytes_short;          // Inputs of 1-63 bytes
+    uint64_t case_bytes_loop;
+    uint64_t case_bytes_tail;
+    uint64_t case_blocks_clean;         // In-place loop blocks not written back
+    uint64_t validate_calls;            // neon_utf8_validate
+    uint64_t validate_failures;
+    uint64_t validate_bytes_loop;
+    uint64_t validate_bytes_tail;
+    uint64_t validate_ascii_blocks;     // Loop blocks that took the ASCII fast path
+    uint64_t count_calls;               // neon_utf8_count_chars
+    uint64_t count_bytes_loop;
+    uint64_t count_bytes_tail;
+} neon_string_ops_stats_t;
+
+// Copies the calling thread's counters to *out and returns 1; in a build
+// without instrumentation *out is zeroed and 0 is returned
+int neon_string_ops_stats(neon_string_ops_stats_t* out);
+void neon_string_ops_stats_reset(void);   // clears the calling thread's counters
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,225 @@
+#ifndef ARM_STRING_OPS_HPP
+#define ARM_STRING_OPS_HPP
+
+// C++17 interface to the ARMv8 NEON String Operations Library
+// Header-only: every function forwards to arm_string_ops.h without
+// allocating. std::span overloads are available when compiling as C++20.
+//
+// Strings shorter than inline_threshold bytes are converted, compared and
+// searched inline: at those sizes the call into the assembly kernels costs
+// more than the work itself.
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define ARM_STRING_OPS_HAS_SPAN 1
+#endif
+
+#include "arm_string_ops.h"
+
+namespace arm_string_ops {
+
+// Inputs below this many bytes skip the kernels
+inline constexpr std::size_t inline_threshold = 16;
+
+// Case conversion operations selectable at compile time
+enum class case_op { upper, lower };
+
+namespace detail {
+
+template <case_op Op>
+constexpr char convert_char(char c) noexcept {
+    constexpr unsigned char first = Op == case_op::upper ? 'a' : 'A';
+    return static_cast<unsigned char>(c - first) < 26 ? static_cast<char>(c ^ 0x20) : c;
+}
+
+constexpr char lower_char(char c) noexcept {
+    return convert_char<case_op::lower>(c);
+}
+
+}  // namespace detail
+
+// In-place case conversion of [data, data + len)
+template <case_op Op>
+inline void transform(char* data, std::size_t len) noexcept {
+    if (len < inline_threshold) {
+        for (std::size_t i = 0; i < len; i++) {
+            data[i] = detail::convert_char<Op>(data[i]);
+        }
+    } else if constexpr (Op == case_op::upper) {
+        neon_to_upper(data, len);
+    } else {
+        neon_to_lower(data, len);
+    }
+}
+
+// Out-of-place case conversion: dst receives src.size() converted bytes
+// (dst may equal src.data(), otherwise the ranges must not overlap)
+template <case_op Op>
+inline void transform(std::string_view src, char* dst) noexcept {
+    if (src.size() < inline_threshold) {
+        for (std::size_t i = 0; i < src.size(); i++) {
+            dst[i] = detail::convert_char<Op>(src[i]);
+        }
+    } else if constexpr (Op == case_op::upper) {
+        neon_to_upper_copy(dst, src.data(), src.size());
+    } else {
+        neon_to_lower_copy(dst, src.data(), src.size());
+    }
+}
+
+template <case_op Op>
+inline void transform(std::string& s) noexcept {
+    transform<Op>(s.data(), s.size());
+}
+
+inline void to_upper(std::string& s) noexcept { transform<case_op::upper>(s); }
+inline void to_lower(std::string& s) noexcept { transform<case_op::lower>(s); }
+inline void to_upper(std::string_view src, char* dst) noexcept { transform<case_op::upper>(src, dst); }
+inline void to_lower(std::string_view src, char* dst) noexcept { transform<case_op::lower>(src, dst); }
+
+#ifdef ARM_STRING_OPS_HAS_SPAN
+template <case_op Op>
+inline void transform(std::span<char> s) noexcept {
+    transform<Op>(s.data(), s.size());
+}
+
+inline void to_upper(std::span<char> s) noexcept { transform<case_op::upper>(s); }
+inline void to_lower(std::span<char> s) noexcept { transform<case_op::lower>(s); }
+#endif
+
+// ASCII case-insensitive equality of two strings
+inline bool iequals(std::string_view a, std::string_view b) noexcept {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    if (a.size() < inline_threshold) {
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (detail::lower_char(a[i]) != detail::lower_char(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return neon_ascii_casecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+// CRC32C of the lowercased bytes (same value as neon_hash_lower)
+inline std::uint32_t hash_lower(std::string_view s, std::uint32_t seed = 0) noexcept {
+    return neon_hash_lower(s.data(), s.size(), seed);
+}
+
+// Search: std::string_view::npos when there is no match
+inline std::size_t find(std::string_view haystack, char c) noexcept {
+    std::size_t i;
+    if (haystack.size() < inline_threshold) {
+        for (i = 0; i < haystack.size() && haystack[i] != c; i++) {
+        }
+    } else {
+        i = neon_memchr(haystack.data(), haystack.size(), static_cast<unsigned char>(c));
+    }
+    return i < haystack.size() ? i : std::string_view::npos;
+}
+
+inline std::size_t find(std::string_view haystack, std::string_view needle) noexcept {
+    std::size_t i = neon_find(haystack.data(), haystack.size(), needle.data(), needle.size());
+    return i < haystack.size() || needle.empty() ? i : std::string_view::npos;
+}
+
+// Case-insensitive substring search
+inline std::size_t ifind(std::string_view haystack, std::string_view needle) noexcept {
+    std::size_t i = neon_find_nocase(haystack.data(), haystack.size(), needle.data(), needle.size());
+    return i < haystack.size() || needle.empty() ? i : std::string_view::npos;
+}
+
+// UTF-8
+inline bool is_ascii(std::string_view s) noexcept {
+    return neon_is_ascii(s.data(), s.size()) != 0;
+}
+
+inline bool is_valid_utf8(std::string_view s) noexcept {
+    return neon_utf8_validate(s.data(), s.size()) != 0;
+}
+
+// Unicode character count; exact for valid UTF-8
+inline std::size_t count_chars(std::string_view s) noexcept {
+    return neon_utf8_count_chars(s.data(), s.size());
+}
+
+// Valid UTF-8 text, iterable as char32_t code points. Only utf8_view::from
+// creates one, after validating the bytes, so the iterator decodes without
+// any checks. The view does not own the bytes
+class utf8_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char32_t*;
+        using reference = char32_t;
+
+        iterator() noexcept = default;
+
+        char32_t operator*() const noexcept {
+            unsigned char c = p_[0];
+            if (c < 0x80) {
+                return c;
+            }
+            if (c < 0xE0) {
+                return (char32_t(c & 0x1F) << 6) | (p_[1] & 0x3F);
+            }
+            if (c < 0xF0) {
+                return (char32_t(c & 0x0F) << 12) | (char32_t(p_[1] & 0x3F) << 6) | (p_[2] & 0x3F);
+            }
+            return (char32_t(c & 0x07) << 18) | (char32_t(p_[1] & 0x3F) << 12) |
+                   (char32_t(p_[2] & 0x3F) << 6) | (p_[3] & 0x3F);
+        }
+
+        iterator& operator++() noexcept {
+            unsigned char c = p_[0];
+            p_ += c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        friend bool operator==(iterator a, iterator b) noexcept { return a.p_ == b.p_; }
+        friend bool operator!=(iterator a, iterator b) noexcept { return a.p_ != b.p_; }
+
+    private:
+        friend class utf8_view;
+        explicit iterator(const char* p) noexcept : p_(reinterpret_cast<const unsigned char*>(p)) {}
+        const unsigned char* p_ = nullptr;
+    };
+
+    // Returns std::nullopt if s is not valid UTF-8
+    static std::optional<utf8_view> from(std::string_view s) noexcept {
+        if (!is_valid_utf8(s)) {
+            return std::nullopt;
+        }
+        return utf8_view(s);
+    }
+
+    iterator begin() const noexcept { return iterator(bytes_.data()); }
+    iterator end() const noexcept { return iterator(bytes_.data() + bytes_.size()); }
+    std::string_view bytes() const noexcept { return bytes_; }
+    std::size_t size() const noexcept { return count_chars(bytes_); }  // code points
+
+private:
+    explicit utf8_view(std::string_view s) noexcept : bytes_(s) {}
+    std::string_view bytes_;
+};
+
+}  // namespace arm_string_ops
+
+#endif
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Generate src/utf8_case_tables.S, the case mapping data used by
+neon_utf8_to_upper / neon_utf8_to_lower (src/utf8_case_ops.S).
+
+The mapping is the Unicode simple case mapping of the Python build running
+this script (its unicodedata version is recorded in the output). Mappings
+that would make the UTF-8 encoding longer are dropped, so converted text is
+never longer than its input.
+
+Two tables are emitted per direction:
+
+  * A vector table for two-byte sequences with lead bytes C3-C5, CE-CF and
+    D0-D3 (Latin-1 Supplement, Latin Extended-A, Greek, Cyrillic), indexed
+    by lead byte and continuation byte. Each entry is the code point delta
+    applied to the continuation's low 6 bits; 0x80 marks a mapping the
+    vector path cannot express (it falls back to the scalar table).
+  * A sorted range table covering every mapped code point, searched by the
+    scalar path.
+
+With --reference it instead writes test/case_reference.h: every mapped
+code point as a plain (code point, mapping) pair, which the scalar reference
+in test/reference.h searches. It shares simple_map() with the tables but
+none of their encoding, so the tests check the vector rows and the range
+packing against the mapping itself.
+
+Usage: python3 scripts/gen_case_tables.py > src/utf8_case_tables.S
+       python3 scripts/gen_case_tables.py --reference > test/case_reference.h
+"""
+
+import sys
+import unicodedata
+
+VECTOR_LEADS = [0xC3, 0xC4, 0xC5, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2, 0xD3]
+FIRST_LEAD = 0xC3
+SENTINEL = 0x80
+
+
+def utf8_len(cp):
+    return 1 if cp < 0x80 else 2 if cp < 0x800 else 3 if cp < 0x10000 else 4
+
+
+# str.upper()/lower() apply the full (SpecialCasing) mappings. Where those
+# expand to several characters, UnicodeData.txt still has these simple ones.
+SIMPLE_UPPER_EXTRA = dict(
+    [(0x1F80 + i, 0x1F88 + i) for i in range(8)] +
+    [(0x1F90 + i, 0x1F98 + i) for i in range(8)] +
+    [(0x1FA0 + i, 0x1FA8 + i) for i in range(8)] +
+    [(0x1FB3, 0x1FBC), (0x1FC3, 0x1FCC), (0x1FF3, 0x1FFC)])
+SIMPLE_LOWER_EXTRA = {0x0130: 0x0069}
+
+
+def simple_map(cp, upper):
+    """Single code point case mapping, or cp itself if there is none."""
+    if 0xD800 <= cp <= 0xDFFF:
+        return cp
+    c = chr(cp)
+    r = c.upper() if upper else c.lower()
+    if len(r) == 1:
+        t = ord(r)
+    else:
+        t = (SIMPLE_UPPER_EXTRA if upper else SIMPLE_LOWER_EXTRA).get(cp, cp)
+    if utf8_len(t) > utf8_len(cp):
+        return cp                       # would grow the encoding
+    return t
+
+
+def vector_tables(upper):
+    rows = {(0,) * 16: 0}
+    rowmap = [0] * 48
+    for cls, lead in enumerate(VECTOR_LEADS):
+        for r in range(4):
+            row = []
+            for k in range(16):
+                idx = r * 16 + k
+                cp = ((lead & 0x1F) << 6) | idx
+                t = simple_map(cp, upper)
+                d = t - cp
+                s = idx + d
+                if d and not (0x80 <= t < 0x800 and -128 < s < 128):
+                    row.append(SENTINEL)
+                else:
+                    row.append(d & 0xFF)
+            row = tuple(row)
+            if row not in rows:
+                rows[row] = len(rows)
+            rowmap[cls * 4 + 1 + r] = rows[row] * 16
+    if len(rows) > 16:
+        sys.exit("too many distinct vector rows: %d" % len(rows))
+    table = [0] * 256
+    for row, rid in rows.items():
+        table[rid * 16:rid * 16 + 16] = row
+    classmap = [0] * 32
+    for cls, lead in enumerate(VECTOR_LEADS):
+        classmap[lead - FIRST_LEAD] = cls * 4 + 1
+    return table, rowmap, classmap
+
+
+def range_table(upper):
+    deltas = {}
+    for cp in range(0x80, 0x110000):
+        t = simple_map(cp, upper)
+        if t != cp:
+            deltas[cp] = t - cp
+    ranges = []                         # [first, count, alternate, delta]
+    for cp in sorted(deltas):
+        d = deltas[cp]
+        if ranges:
+            first, count, alt, rd = ranges[-1]
+            if rd == d:
+                if not alt and cp == first + count and count < 1024:
+                    ranges[-1][1] += 1
+                    continue
+                if (alt or count == 1) and cp == first + count + 1 and count < 1023:
+                    ranges[-1][1] += 2
+                    ranges[-1][2] = 1
+                    continue
+        ranges.append([cp, 1, 0, d])
+    return ranges
+
+
+def emit_bytes(out, data):
+    for i in range(0, len(data), 16):
+        out.append("    .byte   " + ", ".join("0x%02X" % b for b in data[i:i + 16]))
+
+
+def reference():
+    out = [
+        "// Generated by scripts/gen_case_tables.py --reference -- do not edit.",
+        "// Unicode %s simple case mappings of the non-ASCII code points, as"
+        % unicodedata.unidata_version,
+        "// {code point, mapping} pairs sorted by code point (mappings that would",
+        "// lengthen the UTF-8 encoding are omitted, as in src/utf8_case_tables.S)",
+        "",
+        "#ifndef ARM_STRING_OPS_CASE_REFERENCE_H",
+        "#define ARM_STRING_OPS_CASE_REFERENCE_H",
+        "",
+        "#include <stdint.h>",
+    ]
+    for name, upper in (("upper", True), ("lower", False)):
+        pairs = [(cp, simple_map(cp, upper)) for cp in range(0x80, 0x110000)]
+        pairs = ["{0x%04X, 0x%04X}" % (cp, t) for cp, t in pairs if t != cp]
+        out += ["", "static const uint32_t ref_case_%s_map[%d][2] = {" % (name, len(pairs))]
+        for i in range(0, len(pairs), 6):
+            out.append("    " + ", ".join(pairs[i:i + 6]) + ",")
+        out.append("};")
+    out += ["", "#endif"]
+    print("\n".join(out))
+
+
+def main():
+    if sys.argv[1:] == ["--reference"]:
+        reference()
+        return
+    out = [
+        "// Generated by scripts/gen_case_tables.py -- do not edit.",
+        "// Unicode %s simple case mappings (mappings that would lengthen the"
+        % unicodedata.unidata_version,
+        "// UTF-8 encoding are omitted)",
+        "",
+        "// Layout of each direction (see src/utf8_case_ops.S):",
+        "//   +0    vector delta rows, 16 rows of 16 bytes",
+        "//   +256  row offsets, indexed by lead class * 4 + 1 + (cont >> 4 & 3)",
+        "//   +304  lead classes (class * 4 + 1, 0 = not vectorized), indexed by lead - 0xC3",
+        "//   +336  number of scalar ranges",
+        "//   +344  scalar ranges: .word (first << 11) | (count - 1) << 1 | alternate, delta",
+        "",
+        ".include \"platform.inc\"",
+        "",
+        "RODATA",
+    ]
+    for name, upper in (("upper", True), ("lower", False)):
+        table, rowmap, classmap = vector_tables(upper)
+        ranges = range_table(upper)
+        out += [
+            "",
+            ".align 4",
+            "HIDDEN_OBJECT utf8_case_%s_tables" % name,
+        ]
+        emit_bytes(out, table)
+        emit_bytes(out, rowmap)
+        emit_bytes(out, classmap)
+        out.append("    .word   %d, 0" % len(ranges))
+        for first, count, alt, d in ranges:
+            out.append("    .word   0x%08X, %d" % ((first << 11) | (count - 1) << 1 | alt, d))
+        out.append("END_OBJECT utf8_case_%s_tables" % name)
+    print("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
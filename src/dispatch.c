@@ -0,0 +1,112 @@
+// ARMv8 NEON String Operations - Runtime dispatch
+// Binds neon_to_upper, neon_to_lower, neon_utf8_validate and
+// neon_utf8_count_chars to the NEON (_asimd) or SVE (_sve) kernels once,
+// when the library is loaded.
+//
+// SVE is chosen when the kernel reports it in AT_HWCAP and the vectors are
+// at least 256 bits wide. With 128-bit vectors (Neoverse N2/V2) the NEON
+// loops, which take 64 bytes per iteration, are at least as fast on long
+// inputs, so the baseline is kept. ARM_STRING_OPS_IMPL=neon or =sve in the
+// environment overrides the choice; sve is ignored on CPUs without SVE.
+//
+// neon_stream_threshold switches the NEON case and validation kernels to
+// their large-buffer loops (streaming prefetch, non-temporal stores). Inputs
+// that large, and those shorter than SVE_MIN_INPUT, always go to the NEON
+// kernels, whichever family is selected. Both defaults come from tuning.h.
+
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include "arm_string_ops.h"
+#include <tuning.h>             // build/tuning/ after make calibrate, else src/
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+
+#define SVE_MIN_VECTOR_BYTES 32
+
+// Read by case_ops.S and utf8_ops.S (COFF has no symbol visibility)
+#if !defined(_WIN32)
+__attribute__((visibility("hidden")))
+#endif
+size_t neon_stream_threshold = STREAM_DEFAULT_THRESHOLD;
+
+size_t neon_sve_vector_bytes(void);     // sve_ops.S
+
+static void   (*to_upper_impl)(char*, size_t) = neon_to_upper_asimd;
+static void   (*to_lower_impl)(char*, size_t) = neon_to_lower_asimd;
+static int    (*validate_impl)(const char*, size_t) = neon_utf8_validate_asimd;
+static size_t (*count_chars_impl)(const char*, size_t) = neon_utf8_count_chars_asimd;
+static const char* impl_name = "neon";
+
+static int cpu_has_sve(void) {
+#if defined(__linux__) && defined(AT_HWCAP)
+    return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#else
+    return 0;
+#endif
+}
+
+__attribute__((constructor))
+static void dispatch_init(void) {
+    if (!cpu_has_sve()) {
+        return;
+    }
+    const char* force = getenv("ARM_STRING_OPS_IMPL");
+    int use_sve = force ? strcmp(force, "sve") == 0
+                        : neon_sve_vector_bytes() >= SVE_MIN_VECTOR_BYTES;
+    if (use_sve) {
+        to_upper_impl = neon_to_upper_sve;
+        to_lower_impl = neon_to_lower_sve;
+        validate_impl = neon_utf8_validate_sve;
+        count_chars_impl = neon_utf8_count_chars_sve;
+        impl_name = "sve";
+    }
+}
+
+const char* neon_impl_name(void) {
+    return impl_name;
+}
+
+void neon_set_stream_threshold(size_t bytes) {
+    neon_stream_threshold = bytes ? bytes : STREAM_DEFAULT_THRESHOLD;
+}
+
+size_t neon_get_stream_threshold(void) {
+    return neon_stream_threshold;
+}
+
+void neon_to_upper(char* str, size_t len) {
+    if (len < SVE_MIN_INPUT || len >= neon_stream_threshold) {
+        neon_to_upper_asimd(str, len);
+        return;
+    }
+    to_upper_impl(str, len);
+}
+
+void neon_to_lower(char* str, size_t len) {
+    if (len < SVE_MIN_INPUT || len >= neon_stream_threshold) {
+        neon_to_lower_asimd(str, len);
+        return;
+    }
+    to_lower_impl(str, len);
+}
+
+int neon_utf8_validate(const char* str, size_t len) {
+    if (len < SVE_MIN_INPUT || len >= neon_stream_threshold) {
+        return neon_utf8_validate_asimd(str, len);
+    }
+    return validate_impl(str, len);
+}
+
+size_t neon_utf8_count_chars(const char* str, size_t len) {
+    if (len < SVE_MIN_INPUT) {
+        return neon_utf8_count_chars_asimd(str, len);
+    }
+    return count_chars_impl(str, len);
+}
@@ -0,0 +1,220 @@
+// ARMv8 NEON String Operations - Parallel front end
+// Splits large buffers into chunks that worker threads pull from a shared
+// counter and run through the single-threaded kernels, then merges the
+// per-chunk results.
+//
+// Chunks are multiples of 64 bytes, so every chunk boundary is also a block
+// boundary of the sequential UTF-8 validator. A chunk is validated with the
+// streaming API after seeding its state with the 16 bytes in front of the
+// chunk: that is exactly the state a single pass carries into the block, so
+// sequences crossing a seam are checked as if the buffer was read in one go.
+
+#define _DEFAULT_SOURCE
+#include <pthread.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>        // Windows on ARM (llvm-mingw, winpthreads)
+#else
+#include <unistd.h>
+#endif
+#include "arm_string_ops.h"
+#include <tuning.h>             // build/tuning/ after make calibrate, else src/
+
+#define PARALLEL_DEFAULT_CHUNK      (512 * 1024)        // Stays in L2 while it is processed
+#define PARALLEL_MAX_THREADS        256
+
+typedef enum {
+    PARALLEL_VALIDATE,
+    PARALLEL_COUNT,
+    PARALLEL_UPPER,
+    PARALLEL_LOWER,
+    PARALLEL_UPPER_COPY,
+    PARALLEL_LOWER_COPY
+} parallel_op_t;
+
+typedef struct {
+    parallel_op_t op;
+    char*  str;
+    const char* src;     // Source of the _copy operations (str is the destination)
+    size_t len;
+    size_t chunk;        // Bytes per chunk, a multiple of 64
+    size_t chunks;
+    size_t workers;
+    size_t next;         // Next chunk to hand out (atomic)
+    size_t chars;        // Summed character count (atomic)
+    int    failed;       // Set once a chunk is invalid (atomic)
+} parallel_job_t;
+
+static void parallel_chunk(parallel_job_t* job, size_t index) {
+    size_t start = index * job->chunk;
+    size_t len = job->len - start < job->chunk ? job->len - start : job->chunk;
+    char* p = job->str + start;
+
+    switch (job->op) {
+    case PARALLEL_VALIDATE: {
+        neon_utf8_stream_t st;
+        neon_utf8_stream_init(&st);
+        if (start > 0) {
+            memcpy(st.prev, p - sizeof(st.prev), sizeof(st.prev));
+        }
+        int ok = neon_utf8_stream_update(&st, p, len);
+        if (ok && start + len == job->len) {
+            ok = neon_utf8_stream_finish(&st);   // Only the last chunk may not end mid-sequence
+        }
+        if (!ok) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        }
+        break;
+    }
+    case PARALLEL_COUNT:
+        __atomic_fetch_add(&job->chars, neon_utf8_count_chars(p, len), __ATOMIC_RELAXED);
+        break;
+    case PARALLEL_UPPER:
+        neon_to_upper(p, len);
+        break;
+    case PARALLEL_LOWER:
+        neon_to_lower(p, len);
+        break;
+    case PARALLEL_UPPER_COPY:
+        neon_to_upper_copy(p, job->src + start, len);
+        break;
+    case PARALLEL_LOWER_COPY:
+        neon_to_lower_copy(p, job->src + start, len);
+        break;
+    }
+}
+
+// Worker body: take chunks until there are none left (or validation failed)
+static void parallel_work(void* arg) {
+    parallel_job_t* job = arg;
+    for (;;) {
+        if (job->op == PARALLEL_VALIDATE && __atomic_load_n(&job->failed, __ATOMIC_RELAXED)) {
+            break;
+        }
+        size_t index = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (index >= job->chunks) {
+            break;
+        }
+        parallel_chunk(job, index);
+    }
+}
+
+static void* parallel_thread(void* arg) {
+    parallel_work(arg);
+    return NULL;
+}
+
+static long online_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (long)info.dwNumberOfProcessors;
+#else
+    return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+// Fill in the job; returns 0 when the call should stay single-threaded
+static int parallel_setup(parallel_job_t* job, parallel_op_t op, char* str, size_t len,
+                          const neon_parallel_config_t* cfg) {
+    size_t threshold = cfg && cfg->threshold ? cfg->threshold : PARALLEL_DEFAULT_THRESHOLD;
+    size_t chunk = cfg && cfg->chunk_size ? cfg->chunk_size : PARALLEL_DEFAULT_CHUNK;
+    size_t workers = cfg && cfg->threads ? cfg->threads : 0;
+
+    if (str == NULL || len < threshold) {
+        return 0;
+    }
+    if (workers == 0) {
+        long cpus = online_cpus();
+        workers = cpus > 0 ? (size_t)cpus : 1;
+    }
+    chunk = chunk < 64 ? 64 : chunk & ~(size_t)63;
+
+    memset(job, 0, sizeof(*job));
+    job->op = op;
+    job->str = str;
+    job->len = len;
+    job->chunk = chunk;
+    job->chunks = (len + chunk - 1) / chunk;
+    job->workers = workers < job->chunks ? workers : job->chunks;
+    if (job->workers > PARALLEL_MAX_THREADS) {
+        job->workers = PARALLEL_MAX_THREADS;
+    }
+    return job->workers > 1;
+}
+
+static void parallel_run(parallel_job_t* job, const neon_parallel_config_t* cfg) {
+    if (cfg && cfg->spawn) {
+        cfg->spawn(cfg->spawn_ctx, job->workers, parallel_work, job);
+        return;
+    }
+
+    // The calling thread is one of the workers; if a thread cannot be
+    // created the others simply take more chunks
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    size_t started = 0;
+    while (started + 1 < job->workers &&
+           pthread_create(&threads[started], NULL, parallel_thread, job) == 0) {
+        started++;
+    }
+    parallel_work(job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+int neon_utf8_validate_parallel(const char* str, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_VALIDATE, (char*)str, len, cfg)) {
+        return neon_utf8_validate(str, len);
+    }
+    parallel_run(&job, cfg);
+    return !job.failed;
+}
+
+size_t neon_utf8_count_chars_parallel(const char* str, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_COUNT, (char*)str, len, cfg)) {
+        return neon_utf8_count_chars(str, len);
+    }
+    parallel_run(&job, cfg);
+    return job.chars;
+}
+
+void neon_to_upper_parallel(char* str, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_UPPER, str, len, cfg)) {
+        neon_to_upper(str, len);
+        return;
+    }
+    parallel_run(&job, cfg);
+}
+
+void neon_to_lower_parallel(char* str, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_LOWER, str, len, cfg)) {
+        neon_to_lower(str, len);
+        return;
+    }
+    parallel_run(&job, cfg);
+}
+
+void neon_to_upper_copy_parallel(char* dst, const char* src, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_UPPER_COPY, dst, len, cfg)) {
+        neon_to_upper_copy(dst, src, len);
+        return;
+    }
+    job.src = src;
+    parallel_run(&job, cfg);
+}
+
+void neon_to_lower_copy_parallel(char* dst, const char* src, size_t len, const neon_parallel_config_t* cfg) {
+    parallel_job_t job;
+    if (!parallel_setup(&job, PARALLEL_LOWER_COPY, dst, len, cfg)) {
+        neon_to_lower_copy(dst, src, len);
+        return;
+    }
+    job.src = src;
+    parallel_run(&job, cfg);
+}
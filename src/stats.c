@@ -0,0 +1,42 @@
+// ARMv8 NEON String Operations - Hot-path counters
+// Storage and read-out for the counters that the kernels update through
+// STAT_ADD (src/stats.inc) in the instrumented build. The block is
+// thread-local, so the kernels never contend on it; readers see the counters
+// of their own thread only.
+
+#include <stddef.h>
+#include <string.h>
+#include "arm_string_ops.h"
+
+#ifdef ARM_STRING_OPS_STATS
+
+// Updated by case_ops.S, utf8_ops.S and sve_ops.S (initial-exec TLS model)
+__attribute__((visibility("hidden"), tls_model("initial-exec")))
+__thread neon_string_ops_stats_t neon_stats_tls;
+
+// The STAT_* offsets in stats.inc must match the struct layout
+typedef char stats_offsets_check[
+    (offsetof(neon_string_ops_stats_t, case_blocks_clean) == 32 &&
+     offsetof(neon_string_ops_stats_t, validate_ascii_blocks) == 72 &&
+     offsetof(neon_string_ops_stats_t, count_bytes_tail) == 96) ? 1 : -1];
+
+int neon_string_ops_stats(neon_string_ops_stats_t* out) {
+    *out = neon_stats_tls;
+    return 1;
+}
+
+void neon_string_ops_stats_reset(void) {
+    memset(&neon_stats_tls, 0, sizeof(neon_stats_tls));
+}
+
+#else
+
+int neon_string_ops_stats(neon_string_ops_stats_t* out) {
+    memset(out, 0, sizeof(*out));
+    return 0;
+}
+
+void neon_string_ops_stats_reset(void) {
+}
+
+#endif
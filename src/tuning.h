@@ -0,0 +1,32 @@
+// ARMv8 NEON String Operations - Size thresholds
+// Shipped defaults, not measured. make calibrate writes measured values to
+// build/tuning/tuning.h, which is searched before src/ and so replaces this file.
+//
+// Which kernel shape handles an input of a given size:
+//   < 16 bytes                    overlapping 8/4-byte loads; the UTF-8
+//                                 kernels test ASCII in general registers
+//   16-63 bytes                   overlapping 16/32-byte vectors
+//   64 bytes and up               64-byte (TUNE=wide: 128-byte) loop
+//   >= STREAM_DEFAULT_THRESHOLD   streaming prefetch, non-temporal stores
+// With SVE selected, inputs below SVE_MIN_INPUT stay on the NEON kernels.
+// Inputs of PARALLEL_DEFAULT_THRESHOLD bytes or more are split across
+// threads by the *_parallel functions.
+//
+// A -D on the compiler command line overrides any of them.
+
+#ifndef ARM_STRING_OPS_TUNING_H
+#define ARM_STRING_OPS_TUNING_H
+
+#ifndef STREAM_DEFAULT_THRESHOLD
+#define STREAM_DEFAULT_THRESHOLD    16777216
+#endif
+
+#ifndef SVE_MIN_INPUT
+#define SVE_MIN_INPUT               16
+#endif
+
+#ifndef PARALLEL_DEFAULT_THRESHOLD
+#define PARALLEL_DEFAULT_THRESHOLD  4194304
+#endif
+
+#endif // ARM_STRING_OPS_TUNING_H
@@ -1,242 +1,711 @@
+// ARM String Operations Library Benchmark
+// Sweeps sizes (1 B to 1 GiB), source alignments (0-15) and corpora (ASCII,
+// Latin, CJK, emoji, invalid UTF-8) for every kernel and its baselines, and
+// prints one JSON document on stdout so runs can be diffed.
+//
+// Timing: each measurement calls the function back to back until a sample
+// lasts at least --sample-ms, repeats that --samples times and keeps the
+// fastest sample. Wall time comes from CLOCK_MONOTONIC; the tick counter is
+// cntvct_el0 (the generic timer, fixed frequency) or, with --counter cycles,
+// the CPU cycle counter through perf_event_open. No copies or setup work
+// happen inside the timed loop: case conversion is measured out-of-place.
+//
+// Baselines: glibc (toupper loops, memchr, memmem), a portable scalar UTF-8
+// validator/counter, and simdutf when built with `make benchmark SIMDUTF=1`.
+//
+// --calibrate (make calibrate) measures the size thresholds of src/tuning.h
+// into a replacement header.
+
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdint.h>
 #include <ctype.h>
+#include <time.h>
+#include <unistd.h>
 #include "arm_string_ops.h"
 
-// Timing utilities
-double get_time() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec + tv.tv_usec / 1000000.0;
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef HAVE_SIMDUTF
+// test/simdutf_shim.cpp
+int simdutf_shim_validate_utf8(const char* str, size_t len);
+size_t simdutf_shim_count_utf8(const char* str, size_t len);
+size_t simdutf_shim_utf8_to_utf16(const char* str, size_t len, uint16_t* dst);
+#endif
+
+#define MAX_ALIGN 15
+
+// ---------------------------------------------------------------------------
+// Counters
+
+typedef enum { COUNTER_CNTVCT, COUNTER_CYCLES, COUNTER_NONE } counter_t;
+
+static counter_t counter = COUNTER_CNTVCT;
+static int perf_fd = -1;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 }
 
-// Standard library implementations for comparison
-void std_to_upper(char* str, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        str[i] = toupper(str[i]);
+static uint64_t read_ticks(void) {
+#if defined(__aarch64__)
+    if (counter == COUNTER_CNTVCT) {
+        uint64_t v;
+        __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(v) :: "memory");
+        return v;
     }
+#endif
+    if (counter == COUNTER_CYCLES) {
+        uint64_t v = 0;
+        if (read(perf_fd, &v, sizeof(v)) != sizeof(v)) {
+            return 0;
+        }
+        return v;
+    }
+    return 0;
+}
+
+static uint64_t counter_hz(void) {
+#if defined(__aarch64__)
+    if (counter == COUNTER_CNTVCT) {
+        uint64_t f;
+        __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(f));
+        return f;
+    }
+#endif
+    return 0;
 }
 
-void std_to_lower(char* str, size_t len) {
+static const char* counter_name(void) {
+    return counter == COUNTER_CNTVCT ? "cntvct_el0" : counter == COUNTER_CYCLES ? "cycles" : "none";
+}
+
+// Returns 0 if the cycle counter is not available
+static int open_cycle_counter(void) {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return perf_fd >= 0;
+#else
+    return 0;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Corpora
+
+typedef struct {
+    const char* name;
+    const char* sample;
+    int invalid;        // Last byte of every measured slice is made invalid
+} corpus_t;
+
+static const corpus_t corpora[] = {
+    { "ascii", "The quick brown fox jumps over the lazy dog; GET /index.html HTTP/1.1\r\n", 0 },
+    { "latin", "Gr\xc3\xb6\xc3\x9f" "ere \xc3\x9c" "bungen f\xc3\xbcr Sch\xc3\xbcler: caf\xc3\xa9, "
+               "cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e, na\xc3\xafve fa\xc3\xa7" "ade. ", 0 },
+    { "cjk", "\xe6\xbc\xa2\xe5\xad\x97\xe3\x81\x8b\xe3\x81\xaa\xe4\xba\xa4\xe3\x81\x98\xe3\x82\x8a"
+             "\xe6\x96\x87\xe3\x80\x82\xe4\xb8\xad\xe6\x96\x87\xe6\xb5\x8b\xe8\xaf\x95 "
+             "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4 ", 0 },
+    { "emoji", "Launch \xf0\x9f\x9a\x80 party \xf0\x9f\x8e\x89 with \xf0\x9f\x91\xa9\xe2\x80\x8d"
+               "\xf0\x9f\x92\xbb and pizza \xf0\x9f\x8d\x95! ", 0 },
+    { "invalid", "Gr\xc3\xb6\xc3\x9f" "ere \xc3\x9c" "bungen f\xc3\xbcr Sch\xc3\xbcler: caf\xc3\xa9. ", 1 },
+};
+#define NUM_CORPORA (sizeof(corpora) / sizeof(corpora[0]))
+
+static void fill_corpus(char* buf, size_t len, const corpus_t* c) {
+    size_t n = strlen(c->sample);
+    for (size_t i = 0; i < len; i += n) {
+        memcpy(buf + i, c->sample, len - i < n ? len - i : n);
+    }
+}
+
+// Fill the slice at s with the corpus from its first character and return
+// size cut back to a character boundary (0 when not even one fits); the
+// invalid corpus then gets its 0xFF as the last byte
+static size_t corpus_slice(char* s, size_t size, const corpus_t* c) {
+    fill_corpus(s, size + 4, c);        // The bytes after the slice show where it cut
+    while (size > 0 && ((unsigned char)s[size] & 0xC0) == 0x80) {
+        size--;
+    }
+    if (c->invalid && size > 0) {
+        s[size - 1] = (char)0xFF;
+    }
+    return size;
+}
+
+// ---------------------------------------------------------------------------
+// Baselines
+
+static size_t glibc_to_upper_copy(const char* src, char* dst, size_t len) {
     for (size_t i = 0; i < len; i++) {
-        str[i] = tolower(str[i]);
+        dst[i] = (char)toupper((unsigned char)src[i]);
     }
+    return 0;
 }
 
-int std_utf8_validate_simple(const char* str, size_t len) {
-    // Simple ASCII-only validation for comparison
+static size_t glibc_to_lower_copy(const char* src, char* dst, size_t len) {
     for (size_t i = 0; i < len; i++) {
-        if ((unsigned char)str[i] > 127) return 0;
+        dst[i] = (char)tolower((unsigned char)src[i]);
+    }
+    return 0;
+}
+
+// Byte-at-a-time validator with the same rules as neon_utf8_validate
+static int scalar_utf8_validate(const unsigned char* s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        unsigned c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        size_t n;
+        unsigned lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            n = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            return 0;
+        }
+        if (len - i <= n || s[i + 1] < lo || s[i + 1] > hi) {
+            return 0;
+        }
+        for (size_t k = 2; k <= n; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+        i += n + 1;
     }
     return 1;
 }
 
-size_t std_utf8_count_simple(const char* str, size_t len) {
-    // Simple byte counting for ASCII
-    return len;
+static size_t scalar_validate(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)scalar_utf8_validate((const unsigned char*)src, len);
+}
+
+static size_t scalar_count(const char* src, char* dst, size_t len) {
+    (void)dst;
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        n += ((unsigned char)src[i] & 0xC0) != 0x80;
+    }
+    return n;
+}
+
+static size_t glibc_memchr(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)memchr(src, 0x01, len);
+}
+
+static size_t glibc_memmem(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)memmem(src, len, "\x01needle", 7);
+}
+
+#ifdef HAVE_SIMDUTF
+static size_t simdutf_validate(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)simdutf_shim_validate_utf8(src, len);
+}
+
+static size_t simdutf_count(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return simdutf_shim_count_utf8(src, len);
+}
+
+static size_t simdutf_to_utf16(const char* src, char* dst, size_t len) {
+    return simdutf_shim_utf8_to_utf16(src, len, (uint16_t*)dst);
 }
+#endif
+
+// ---------------------------------------------------------------------------
+// Library kernels
+
+static size_t neon_upper_copy(const char* src, char* dst, size_t len) {
+    neon_to_upper_copy(dst, src, len);
+    return 0;
+}
+
+static size_t neon_lower_copy(const char* src, char* dst, size_t len) {
+    neon_to_lower_copy(dst, src, len);
+    return 0;
+}
+
+static size_t neon_validate(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)neon_utf8_validate(src, len);
+}
+
+static size_t neon_count(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return neon_utf8_count_chars(src, len);
+}
+
+static size_t neon_to_utf16(const char* src, char* dst, size_t len) {
+    size_t out = 0;
+    neon_utf8_to_utf16(src, len, (uint16_t*)dst, &out);
+    return out;
+}
+
+static size_t neon_memchr_absent(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return neon_memchr(src, len, 0x01);
+}
+
+static size_t neon_find_absent(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return neon_find(src, len, "\x01needle", 7);
+}
+
+typedef size_t (*bench_fn)(const char* src, char* dst, size_t len);
 
-// Benchmark framework
 typedef struct {
-    const char* name;
-    void (*setup)(char** data, size_t size);
-    double (*benchmark_neon)(char* data, size_t size, int iterations);
-    double (*benchmark_std)(char* data, size_t size, int iterations);
-} benchmark_t;
-
-// Setup functions for different data types
-void setup_mixed_case(char** data, size_t size) {
-    *data = malloc(size + 1);
-    for (size_t i = 0; i < size; i++) {
-        if (i % 2 == 0) {
-            (*data)[i] = 'A' + (i % 26);
-        } else {
-            (*data)[i] = 'a' + (i % 26);
+    const char* function;
+    const char* impl;
+    bench_fn    run;
+    int         wide_output;    // dst holds 2 bytes per input byte, kept 2-byte aligned
+} bench_t;
+
+static const bench_t benches[] = {
+    { "to_upper_copy",    "neon",    neon_upper_copy,     0 },
+    { "to_upper_copy",    "glibc",   glibc_to_upper_copy, 0 },
+    { "to_lower_copy",    "neon",    neon_lower_copy,     0 },
+    { "to_lower_copy",    "glibc",   glibc_to_lower_copy, 0 },
+    { "utf8_validate",    "neon",    neon_validate,       0 },
+    { "utf8_validate",    "scalar",  scalar_validate,     0 },
+    { "utf8_count_chars", "neon",    neon_count,          0 },
+    { "utf8_count_chars", "scalar",  scalar_count,        0 },
+    { "utf8_to_utf16",    "neon",    neon_to_utf16,       1 },
+    { "memchr",           "neon",    neon_memchr_absent,  0 },
+    { "memchr",           "glibc",   glibc_memchr,        0 },
+    { "find",             "neon",    neon_find_absent,    0 },
+    { "find",             "glibc",   glibc_memmem,        0 },
+#ifdef HAVE_SIMDUTF
+    { "utf8_validate",    "simdutf", simdutf_validate,    0 },
+    { "utf8_count_chars", "simdutf", simdutf_count,       0 },
+    { "utf8_to_utf16",    "simdutf", simdutf_to_utf16,    1 },
+#endif
+};
+#define NUM_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+// ---------------------------------------------------------------------------
+// Measurement
+
+typedef struct {
+    size_t min_size;
+    size_t max_size;
+    int    align;           // -1: every alignment 0-15
+    const char* corpus;     // NULL: all
+    const char* function;   // NULL: all
+    int    samples;
+    uint64_t sample_ns;
+} options_t;
+
+static volatile size_t sink;
+
+typedef struct {
+    uint64_t calls;
+    double   ns;            // Per call, fastest sample
+    double   ticks;         // Per call, same sample
+} result_t;
+
+static result_t measure(const bench_t* b, const char* src, char* dst, size_t len, const options_t* opt) {
+    // Double the call count until one sample is long enough
+    uint64_t calls = 1;
+    for (;;) {
+        uint64_t t0 = now_ns();
+        for (uint64_t i = 0; i < calls; i++) {
+            sink += b->run(src, dst, len);
+        }
+        uint64_t dt = now_ns() - t0;
+        if (dt >= opt->sample_ns || calls >= (1ULL << 40)) {
+            break;
         }
+        calls = dt * 4 < opt->sample_ns ? calls * 4 : calls * 2;
     }
-    (*data)[size] = '\0';
+
+    result_t r = { calls, 0.0, 0.0 };
+    for (int s = 0; s < opt->samples; s++) {
+        uint64_t k0 = read_ticks();
+        uint64_t t0 = now_ns();
+        for (uint64_t i = 0; i < calls; i++) {
+            sink += b->run(src, dst, len);
+        }
+        uint64_t t1 = now_ns();
+        uint64_t k1 = read_ticks();
+        double ns = (double)(t1 - t0) / (double)calls;
+        if (s == 0 || ns < r.ns) {
+            r.ns = ns;
+            r.ticks = (double)(k1 - k0) / (double)calls;
+        }
+    }
+    return r;
 }
 
-void setup_all_lower(char** data, size_t size) {
-    *data = malloc(size + 1);
-    for (size_t i = 0; i < size; i++) {
-        (*data)[i] = 'a' + (i % 26);
+// Parse sizes like 4096, 64K, 16M, 1G
+static size_t parse_size(const char* s) {
+    char* end;
+    unsigned long long v = strtoull(s, &end, 0);
+    switch (*end) {
+    case 'K': case 'k': v <<= 10; break;
+    case 'M': case 'm': v <<= 20; break;
+    case 'G': case 'g': v <<= 30; break;
+    default: break;
     }
-    (*data)[size] = '\0';
+    return (size_t)v;
+}
+
+// ---------------------------------------------------------------------------
+// Calibration (--calibrate): measures where the next kernel shape starts to
+// pay off and prints a tuning.h with those sizes on stdout
+
+static size_t cal_upper_loop(const char* src, char* dst, size_t len) {
+    neon_set_stream_threshold(SIZE_MAX);
+    neon_to_upper_copy(dst, src, len);
+    return 0;
 }
 
-void setup_all_upper(char** data, size_t size) {
-    *data = malloc(size + 1);
-    for (size_t i = 0; i < size; i++) {
-        (*data)[i] = 'A' + (i % 26);
+static size_t cal_upper_stream(const char* src, char* dst, size_t len) {
+    neon_set_stream_threshold(1);
+    neon_to_upper_copy(dst, src, len);
+    return 0;
+}
+
+static size_t cal_validate_loop(const char* src, char* dst, size_t len) {
+    (void)dst;
+    neon_set_stream_threshold(SIZE_MAX);
+    return (size_t)neon_utf8_validate_asimd(src, len);
+}
+
+static size_t cal_validate_stream(const char* src, char* dst, size_t len) {
+    (void)dst;
+    neon_set_stream_threshold(1);
+    return (size_t)neon_utf8_validate_asimd(src, len);
+}
+
+// In place on dst, which holds a copy of the source; after the first call
+// it is upper case, so these time the scan of text that needs no stores
+static size_t cal_upper_asimd(const char* src, char* dst, size_t len) {
+    (void)src;
+    neon_to_upper_asimd(dst, len);
+    return 0;
+}
+
+static size_t cal_upper_sve(const char* src, char* dst, size_t len) {
+    (void)src;
+    neon_to_upper_sve(dst, len);
+    return 0;
+}
+
+static size_t cal_validate_asimd(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)neon_utf8_validate_asimd(src, len);
+}
+
+static size_t cal_validate_sve(const char* src, char* dst, size_t len) {
+    (void)dst;
+    return (size_t)neon_utf8_validate_sve(src, len);
+}
+
+static size_t cal_validate_parallel(const char* src, char* dst, size_t len) {
+    neon_parallel_config_t cfg = { 0 };
+    (void)dst;
+    cfg.threshold = 1;
+    return (size_t)neon_utf8_validate_parallel(src, len, &cfg);
+}
+
+static const bench_t cal_benches[] = {
+    { "stream",   "upper_loop",        cal_upper_loop,        0 },
+    { "stream",   "upper_stream",      cal_upper_stream,      0 },
+    { "stream",   "validate_loop",     cal_validate_loop,     0 },
+    { "stream",   "validate_stream",   cal_validate_stream,   0 },
+    { "sve",      "upper_asimd",       cal_upper_asimd,       0 },
+    { "sve",      "upper_sve",         cal_upper_sve,         0 },
+    { "sve",      "validate_asimd",    cal_validate_asimd,    0 },
+    { "sve",      "validate_sve",      cal_validate_sve,      0 },
+    { "parallel", "validate",          neon_validate,         0 },
+    { "parallel", "validate_parallel", cal_validate_parallel, 0 },
+};
+
+// Smallest power of two in [from, to] from which cal_benches[alt] takes at
+// most slack times as long as cal_benches[base] at every size measured;
+// none when there is no such size
+static size_t crossover(size_t base, size_t alt, double slack, size_t from, size_t to,
+                        const char* src, char* dst, const options_t* opt, size_t none) {
+    size_t found = none;
+    for (size_t size = from; size >= from && size <= to; size *= 2) {
+        memcpy(dst, src, size);
+        result_t a = measure(&cal_benches[base], src, dst, size, opt);
+        result_t b = measure(&cal_benches[alt], src, dst, size, opt);
+        fprintf(stderr, "calibrate %-8s %10zu B: %s %.1f ns, %s %.1f ns\n", cal_benches[base].function,
+                size, cal_benches[base].impl, a.ns, cal_benches[alt].impl, b.ns);
+        if (b.ns <= a.ns * slack) {
+            if (found == none) {
+                found = size;
+            }
+        } else {
+            found = none;
+        }
     }
-    (*data)[size] = '\0';
+    return found;
 }
 
-void setup_ascii_text(char** data, size_t size) {
-    *data = malloc(size + 1);
-    const char* sample = "The quick brown fox jumps over the lazy dog. ";
-    size_t sample_len = strlen(sample);
-    
-    for (size_t i = 0; i < size; i++) {
-        (*data)[i] = sample[i % sample_len];
+static int calibrate(const char* src, char* dst, const options_t* opt) {
+    size_t stream_default, sve_min = 16, sve_to = 0, parallel = (size_t)-1;
+
+    neon_set_stream_threshold(0);
+    stream_default = neon_get_stream_threshold();
+
+    // Streaming: the non-temporal loop may lose a little raw throughput and
+    // still be the better choice, since it leaves other data in the caches,
+    // so it is taken from where it is within 2%. When it never gets there,
+    // the library default stays
+    size_t upper = crossover(0, 1, 1.02, 256 * 1024, opt->max_size, src, dst, opt, 0);
+    size_t validate = crossover(2, 3, 1.02, 256 * 1024, opt->max_size, src, dst, opt, 0);
+    size_t stream = upper > validate ? upper : validate;
+    if (upper == 0 || validate == 0) {
+        stream = stream_default;
+    }
+    neon_set_stream_threshold(0);
+
+    // SVE: only measured when the library selected it; below the crossover
+    // the NEON kernels, with their scalar paths for short inputs, are used.
+    // When SVE never wins for one of them, NEON is kept at every size
+    if (strcmp(neon_impl_name(), "sve") == 0) {
+        sve_to = opt->max_size < 4096 ? opt->max_size : 4096;
+        upper = crossover(4, 5, 1.0, 1, sve_to, src, dst, opt, (size_t)-1);
+        validate = crossover(6, 7, 1.0, 1, sve_to, src, dst, opt, (size_t)-1);
+        sve_min = upper > validate ? upper : validate;
     }
-    (*data)[size] = '\0';
-}
-
-// Case conversion benchmarks
-double benchmark_neon_to_upper(char* data, size_t size, int iterations) {
-    char* work_buffer = malloc(size + 1);
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        memcpy(work_buffer, data, size + 1);
-        neon_to_upper(work_buffer, size);
-    }
-    
-    double end = get_time();
-    free(work_buffer);
-    return end - start;
-}
-
-double benchmark_std_to_upper(char* data, size_t size, int iterations) {
-    char* work_buffer = malloc(size + 1);
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        memcpy(work_buffer, data, size + 1);
-        std_to_upper(work_buffer, size);
-    }
-    
-    double end = get_time();
-    free(work_buffer);
-    return end - start;
-}
-
-double benchmark_neon_to_lower(char* data, size_t size, int iterations) {
-    char* work_buffer = malloc(size + 1);
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        memcpy(work_buffer, data, size + 1);
-        neon_to_lower(work_buffer, size);
-    }
-    
-    double end = get_time();
-    free(work_buffer);
-    return end - start;
-}
-
-double benchmark_std_to_lower(char* data, size_t size, int iterations) {
-    char* work_buffer = malloc(size + 1);
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        memcpy(work_buffer, data, size + 1);
-        std_to_lower(work_buffer, size);
-    }
-    
-    double end = get_time();
-    free(work_buffer);
-    return end - start;
-}
-
-// UTF-8 validation benchmarks
-double benchmark_neon_utf8_validate(char* data, size_t size, int iterations) {
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        neon_utf8_validate(data, size);
-    }
-    
-    double end = get_time();
-    return end - start;
-}
-
-double benchmark_std_utf8_validate(char* data, size_t size, int iterations) {
-    double start = get_time();
-    
-    for (int i = 0; i < iterations; i++) {
-        std_utf8_validate_simple(data, size);
-    }
-    
-    double end = get_time();
-    return end - start;
-}
-
-
-// Run a single benchmark
-void run_benchmark(const char* name, 
-                  double (*neon_func)(char*, size_t, int),
-                  double (*std_func)(char*, size_t, int),
-                  char* data, size_t size, int iterations) {
-    
-    printf("\n%s Benchmark (%zu bytes, %d iterations):\n", name, size, iterations);
-    printf("----------------------------------------\n");
-    
-    double neon_time = neon_func(data, size, iterations);
-    double std_time = std_func(data, size, iterations);
-    
-    double neon_throughput = (size * iterations) / (neon_time * 1024 * 1024 * 1024);
-    double std_throughput = (size * iterations) / (std_time * 1024 * 1024 * 1024);
-    double speedup = std_time / neon_time;
-    
-    printf("NEON implementation: %.4f seconds (%.2f GB/s)\n", neon_time, neon_throughput);
-    printf("Standard library:    %.4f seconds (%.2f GB/s)\n", std_time, std_throughput);
-    printf("Speedup: %.2fx\n", speedup);
-    
-    if (speedup > 1.0) {
-        printf("✓ NEON is faster\n");
-    } else if (speedup > 0.9) {
-        printf("≈ Performance is similar\n");
+
+    // Threads: worth it from where they save at least 10%; a machine where
+    // they never do keeps the parallel front end single-threaded
+    parallel = crossover(8, 9, 0.9, 256 * 1024, opt->max_size, src, dst, opt, parallel);
+
+    printf("// ARMv8 NEON String Operations - Size thresholds\n"
+           "// Generated by make calibrate (build/benchmark --calibrate)\n"
+           "// Measured on this machine with the %s kernels.\n"
+           "//\n"
+           "// Which kernel shape handles an input of a given size:\n"
+           "//   < 16 bytes                    overlapping 8/4-byte loads; the UTF-8\n"
+           "//                                 kernels test ASCII in general registers\n"
+           "//   16-63 bytes                   overlapping 16/32-byte vectors\n"
+           "//   64 bytes and up               64-byte (TUNE=wide: 128-byte) loop\n"
+           "//   >= STREAM_DEFAULT_THRESHOLD   streaming prefetch, non-temporal stores\n"
+           "// With SVE selected, inputs below SVE_MIN_INPUT stay on the NEON kernels.\n"
+           "// Inputs of PARALLEL_DEFAULT_THRESHOLD bytes or more are split across\n"
+           "// threads by the *_parallel functions.\n"
+           "//\n"
+           "// A -D on the compiler command line overrides any of them.\n"
+           "\n"
+           "#ifndef ARM_STRING_OPS_TUNING_H\n"
+           "#define ARM_STRING_OPS_TUNING_H\n"
+           "\n"
+           "#ifndef STREAM_DEFAULT_THRESHOLD\n"
+           "#define STREAM_DEFAULT_THRESHOLD    %zu\n"
+           "#endif\n"
+           "\n"
+           "#ifndef SVE_MIN_INPUT\n",
+           neon_impl_name(), stream);
+    if (sve_min == (size_t)-1) {
+        printf("#define SVE_MIN_INPUT               ((size_t)-1)    // SVE never won up to %zu bytes\n",
+               sve_to);
     } else {
-        printf("✗ Standard library is faster\n");
-    }
-}
-
-int main() {
-    printf("ARM String Operations Library Benchmark\n");
-    printf("======================================\n");
-    
-    const size_t sizes[] = {1024, 16*1024, 256*1024, 1024*1024};
-    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
-    const int iterations = 1000;
-    
-    for (size_t s = 0; s < num_sizes; s++) {
-        size_t size = sizes[s];
-        printf("\n" "=" "50" "s" "\n", "");
-        printf("Testing with %zu bytes\n", size);
-        printf("" "=" "50" "s" "\n", "");
-        
-        // Case conversion benchmarks
-        char* mixed_data;
-        setup_mixed_case(&mixed_data, size);
-        run_benchmark("Case Conversion (to_upper)", 
-                     benchmark_neon_to_upper, benchmark_std_to_upper,
-                     mixed_data, size, iterations);
-        
-        run_benchmark("Case Conversion (to_lower)", 
-                     benchmark_neon_to_lower, benchmark_std_to_lower,
-                     mixed_data, size, iterations);
-        free(mixed_data);
-        
-        // UTF-8 validation benchmarks
-        char* ascii_data;
-        setup_ascii_text(&ascii_data, size);
-        run_benchmark("UTF-8 Validation", 
-                     benchmark_neon_utf8_validate, benchmark_std_utf8_validate,
-                     ascii_data, size, iterations);
-        
-        free(ascii_data);
-    }
-    
-    printf("\n" "=" "50" "s" "\n", "");
-    printf("Benchmark Complete\n");
-    printf("Note: Results may vary based on CPU, memory, and system load.\n");
-    printf("For best results, run on an ARMv8 system with NEON support.\n");
-    
+        printf("#define SVE_MIN_INPUT               %zu\n", sve_min);
+    }
+    printf("#endif\n"
+           "\n"
+           "#ifndef PARALLEL_DEFAULT_THRESHOLD\n");
+    if (parallel == (size_t)-1) {
+        printf("#define PARALLEL_DEFAULT_THRESHOLD  ((size_t)-1)    // Threads never paid off\n");
+    } else {
+        printf("#define PARALLEL_DEFAULT_THRESHOLD  %zu\n", parallel);
+    }
+    printf("#endif\n"
+           "\n"
+           "#endif // ARM_STRING_OPS_TUNING_H\n");
+    return 0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --min-size N       smallest size (default 1)\n"
+            "  --max-size N       largest size, K/M/G suffixes allowed (default 1G)\n"
+            "  --align N|all      source alignment 0-15 (default all)\n"
+            "  --corpus NAME      ascii, latin, cjk, emoji or invalid (default all)\n"
+            "  --function NAME    e.g. utf8_validate (default all)\n"
+            "  --samples N        samples per measurement, fastest is kept (default 5)\n"
+            "  --sample-ms N      minimum sample duration (default 2)\n"
+            "  --counter NAME     cntvct, cycles or none (default cntvct)\n"
+            "  --calibrate        print a tuning.h measured on this machine (--corpus\n"
+            "                     picks the text, default ascii; --max-size default 256M)\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    options_t opt = { 1, (size_t)1 << 30, -1, NULL, NULL, 5, 2000000 };
+    int calibrating = 0, max_size_set = 0;
+#if !defined(__aarch64__)
+    counter = COUNTER_NONE;
+#endif
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--calibrate") == 0) {
+            calibrating = 1;
+            continue;
+        }
+        if (v && strcmp(a, "--min-size") == 0) {
+            opt.min_size = parse_size(v);
+        } else if (v && strcmp(a, "--max-size") == 0) {
+            opt.max_size = parse_size(v);
+            max_size_set = 1;
+        } else if (v && strcmp(a, "--align") == 0) {
+            opt.align = strcmp(v, "all") == 0 ? -1 : atoi(v) & MAX_ALIGN;
+        } else if (v && strcmp(a, "--corpus") == 0) {
+            opt.corpus = v;
+        } else if (v && strcmp(a, "--function") == 0) {
+            opt.function = v;
+        } else if (v && strcmp(a, "--samples") == 0) {
+            opt.samples = atoi(v) > 0 ? atoi(v) : 1;
+        } else if (v && strcmp(a, "--sample-ms") == 0) {
+            opt.sample_ns = (uint64_t)atoi(v) * 1000000ULL;
+        } else if (v && strcmp(a, "--counter") == 0) {
+            counter = strcmp(v, "cycles") == 0 ? COUNTER_CYCLES
+                    : strcmp(v, "none") == 0 ? COUNTER_NONE : COUNTER_CNTVCT;
+        } else {
+            usage(argv[0]);
+            return a[1] == '-' && a[2] == 'h' ? 0 : 1;
+        }
+        i++;
+    }
+    if (opt.min_size == 0) {
+        opt.min_size = 1;
+    }
+    if (calibrating && !max_size_set) {
+        opt.max_size = (size_t)256 << 20;
+    }
+    if (counter == COUNTER_CYCLES && !open_cycle_counter()) {
+        fprintf(stderr, "cycle counter unavailable (perf_event_open), using cntvct_el0\n");
+        counter = COUNTER_CNTVCT;
+    }
+#if !defined(__aarch64__)
+    if (counter == COUNTER_CNTVCT) {
+        counter = COUNTER_NONE;
+    }
+#endif
+
+    // One source and one destination buffer for every run; the destination
+    // holds two bytes per input byte for the UTF-16 output
+    char* src = NULL;
+    char* dst = NULL;
+    while (opt.max_size >= opt.min_size) {
+        src = malloc(opt.max_size + MAX_ALIGN + 64);
+        dst = malloc(2 * opt.max_size + MAX_ALIGN + 64);
+        if (src && dst) {
+            break;
+        }
+        free(src);
+        free(dst);
+        src = dst = NULL;
+        opt.max_size /= 2;
+        fprintf(stderr, "out of memory, reducing --max-size to %zu\n", opt.max_size);
+    }
+    if (!src) {
+        return 1;
+    }
+    src = (char*)(((uintptr_t)src + 63) & ~(uintptr_t)63);
+    dst = (char*)(((uintptr_t)dst + 63) & ~(uintptr_t)63);
+    memset(dst, 0, 2 * opt.max_size + MAX_ALIGN);
+
+    if (calibrating) {
+        const corpus_t* corpus = &corpora[0];
+        for (size_t c = 0; c < NUM_CORPORA; c++) {
+            if (opt.corpus && strcmp(opt.corpus, corpora[c].name) == 0) {
+                corpus = &corpora[c];
+            }
+        }
+        fill_corpus(src, opt.max_size, corpus);
+        return calibrate(src, dst, &opt);
+    }
+
+    printf("{\n");
+    printf("  \"library_impl\": \"%s\",\n", neon_impl_name());
+    printf("  \"counter\": \"%s\",\n", counter_name());
+    printf("  \"counter_hz\": %llu,\n", (unsigned long long)counter_hz());
+    printf("  \"samples\": %d,\n", opt.samples);
+    printf("  \"sample_ms\": %llu,\n", (unsigned long long)(opt.sample_ns / 1000000ULL));
+    printf("  \"results\": [");
+
+    int first = 1;
+    for (size_t c = 0; c < NUM_CORPORA; c++) {
+        const corpus_t* corpus = &corpora[c];
+        if (opt.corpus && strcmp(opt.corpus, corpus->name) != 0) {
+            continue;
+        }
+        fprintf(stderr, "corpus %s\n", corpus->name);
+
+        // Powers of two and the midpoints between them, so tail handling shows up
+        for (size_t base = 1; base <= opt.max_size; base *= 2) {
+            for (int half = 0; half < 2; half++) {
+                size_t nominal = half ? base + base / 2 : base;
+                if ((half && base < 2) || nominal < opt.min_size || nominal > opt.max_size) {
+                    continue;
+                }
+                for (int align = 0; align <= MAX_ALIGN; align++) {
+                    if (opt.align >= 0 && align != opt.align) {
+                        continue;
+                    }
+                    // Every slice starts and ends on a character boundary,
+                    // so the valid corpora really are valid UTF-8
+                    char* s = src + align;
+                    size_t size = corpus_slice(s, nominal, corpus);
+                    if (size == 0) {
+                        continue;
+                    }
+                    for (size_t f = 0; f < NUM_BENCHES; f++) {
+                        const bench_t* b = &benches[f];
+                        if (opt.function && strcmp(opt.function, b->function) != 0) {
+                            continue;
+                        }
+                        char* d = b->wide_output ? dst : dst + align;
+                        result_t r = measure(b, s, d, size, &opt);
+                        printf("%s\n    {\"function\": \"%s\", \"impl\": \"%s\", \"corpus\": \"%s\", "
+                               "\"size\": %zu, \"align\": %d, \"calls\": %llu, \"ns_per_call\": %.3f, "
+                               "\"ticks_per_call\": %.3f, \"gbps\": %.4f}",
+                               first ? "" : ",", b->function, b->impl, corpus->name, size, align,
+                               (unsigned long long)r.calls, r.ns, r.ticks, (double)size / r.ns);
+                        first = 0;
+                    }
+                }
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,354 @@
+// Fuzz target: runs every kernel on the fuzzer's input and compares with
+// the scalar references in reference.h, aborting on the first difference
+//
+// libFuzzer (clang):  make fuzz && build/fuzz_kernels corpus/
+// AFL++ or replay:    built with -DFUZZ_STANDALONE, main() runs each file
+//                     named on the command line, or stdin (afl-fuzz ... @@)
+//
+// Sanitizers do not see loads made from assembly, so the input is copied
+// to the end of a page followed by a PROT_NONE page: a kernel reading past
+// the end faults instead of passing silently. Output buffers get the same
+// treatment at exactly their documented size.
+//
+// The first input byte picks the needle, delimiter and split parameters;
+// the rest is the data.
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#include "arm_string_ops.h"
+#include "reference.h"
+
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+
+#define MAX_INPUT   (16 * 1024)
+#define REGION_SIZE (64 * 1024)         // Room for the largest output, 4 * MAX_INPUT
+
+#define EXPECT(cond, what) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "fuzz_kernels: %s differs from the reference (len %zu)\n", what, len); \
+            abort(); \
+        } \
+    } while (0)
+
+static uint8_t* region_end[3];
+static int has_sve;
+
+static void regions_init(void) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    for (int r = 0; r < 3; r++) {
+        uint8_t* p = mmap(NULL, REGION_SIZE + page, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            perror("mmap");
+            abort();
+        }
+        mprotect(p + REGION_SIZE, page, PROT_NONE);
+        region_end[r] = p + REGION_SIZE;
+    }
+#if defined(__linux__) && defined(AT_HWCAP)
+    has_sve = (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#endif
+}
+
+// n bytes ending at the guard page of region r
+static uint8_t* tail(int r, size_t n) {
+    return region_end[r] - n;
+}
+
+// Reference outputs, word aligned so they can be read as UTF-16 and UTF-32
+static uint32_t ref_words_a[MAX_INPUT], ref_words_b[MAX_INPUT];
+static uint8_t* const ref_a = (uint8_t*)ref_words_a;
+static uint8_t* const ref_b = (uint8_t*)ref_words_b;
+
+typedef void (*case_fn)(char*, size_t);
+
+static void expect_case(uint8_t* s, const uint8_t* data, size_t len, case_fn fn, int upper,
+                        const char* what) {
+    memcpy(s, data, len);
+    fn((char*)s, len);
+    for (size_t i = 0; i < len; i++) {
+        EXPECT(s[i] == (upper ? ref_upper(data[i]) : ref_lower(data[i])), what);
+    }
+    memcpy(s, data, len);
+}
+
+static void fuzz_case(const uint8_t* data, size_t len, uint8_t param) {
+    uint8_t* s = tail(0, len);
+    uint8_t* dst = tail(1, len);
+    size_t off, n, wn;
+    int want, got;
+
+    // Case conversion and hashing
+    neon_to_upper_copy((char*)dst, (const char*)s, len);
+    for (size_t i = 0; i < len; i++) {
+        EXPECT(dst[i] == ref_upper(data[i]), "neon_to_upper_copy");
+    }
+    memcpy(s, data, len);
+    neon_to_lower((char*)s, len);
+    for (size_t i = 0; i < len; i++) {
+        EXPECT(s[i] == ref_lower(data[i]), "neon_to_lower");
+    }
+    expect_case(s, data, len, neon_to_upper, 1, "neon_to_upper");
+    expect_case(s, data, len, neon_to_upper_asimd, 1, "neon_to_upper_asimd");
+    expect_case(s, data, len, neon_to_lower_asimd, 0, "neon_to_lower_asimd");
+    if (has_sve) {
+        expect_case(s, data, len, neon_to_upper_sve, 1, "neon_to_upper_sve");
+        expect_case(s, data, len, neon_to_lower_sve, 0, "neon_to_lower_sve");
+    }
+    got = neon_ascii_casecmp((const char*)s, (const char*)dst, len);
+    want = ref_casecmp(data, dst, len);
+    EXPECT((got > 0) - (got < 0) == want, "neon_ascii_casecmp");
+    EXPECT(neon_hash_lower((const char*)s, len, param) == ref_hash_lower(data, len, param), "neon_hash_lower");
+
+    for (int upper = 0; upper < 2; upper++) {
+        const char* what = upper ? "neon_utf8_to_upper" : "neon_utf8_to_lower";
+        n = (upper ? neon_utf8_to_upper : neon_utf8_to_lower)((char*)dst, (const char*)s, len);
+        wn = ref_utf8_case(ref_a, data, len, upper);
+        EXPECT(n == wn && memcmp(dst, ref_a, n) == 0, what);
+    }
+
+    // Key table: keys cut from the data at offsets picked by param, then the
+    // data prefix of every key length looked up
+    static neon_key_table_t table;
+    const char* keys[8];
+    size_t key_lens[8], nkeys = 1 + param % 8;
+    size_t max_key = len < NEON_KEY_TABLE_MAX_LEN ? len : NEON_KEY_TABLE_MAX_LEN;
+    for (size_t k = 0; k < nkeys; k++) {
+        key_lens[k] = (param + 13 * k) % (max_key + 1);
+        keys[k] = (const char*)data + (len - key_lens[k]) * k / 8;
+    }
+    EXPECT(neon_key_table_init(&table, keys, key_lens, nkeys) == 1, "neon_key_table_init");
+    for (size_t k = 0; k <= nkeys; k++) {
+        size_t m = k < nkeys ? key_lens[k] : max_key;
+        int key_want = -1;
+        for (size_t i = 0; i < nkeys && key_want < 0; i++) {
+            if (key_lens[i] == m && ref_casecmp((const uint8_t*)keys[i], data, m) == 0) {
+                key_want = (int)i;
+            }
+        }
+        EXPECT(neon_key_table_find(&table, (const char*)s, m) == key_want, "neon_key_table_find");
+    }
+
+    // UTF-8
+    want = ref_utf8_validate(data, len, &off);
+    EXPECT(neon_utf8_validate((const char*)s, len) == want, "neon_utf8_validate");
+    EXPECT(neon_utf8_validate_ex((const char*)s, len, &n) == want && n == off, "neon_utf8_validate_ex");
+    EXPECT(neon_utf8_validate_count((const char*)s, len, &n) == want &&
+           (!want || n == ref_count_chars(data, len)), "neon_utf8_validate_count");
+    EXPECT(neon_utf8_count_chars((const char*)s, len) == ref_count_chars(data, len), "neon_utf8_count_chars");
+    EXPECT(neon_utf8_validate_asimd((const char*)s, len) == want, "neon_utf8_validate_asimd");
+    EXPECT(neon_utf8_count_chars_asimd((const char*)s, len) == ref_count_chars(data, len),
+           "neon_utf8_count_chars_asimd");
+    if (has_sve) {
+        EXPECT(neon_utf8_validate_sve((const char*)s, len) == want, "neon_utf8_validate_sve");
+        EXPECT(neon_utf8_count_chars_sve((const char*)s, len) == ref_count_chars(data, len),
+               "neon_utf8_count_chars_sve");
+    }
+    EXPECT(neon_is_ascii((const char*)s, len) == ref_is_ascii(data, len), "neon_is_ascii");
+
+    uint8_t* wide = tail(1, 3 * len);
+    n = neon_utf8_sanitize((char*)wide, (const char*)s, len);
+    wn = ref_utf8_sanitize(ref_a, data, len);
+    EXPECT(n == wn && memcmp(wide, ref_a, n) == 0, "neon_utf8_sanitize");
+
+    uint16_t* d16 = (uint16_t*)tail(1, 2 * len);
+    got = neon_utf8_to_utf16((const char*)s, len, d16, &n);
+    want = ref_utf8_to_utf16(data, len, (uint16_t*)ref_a, &wn);
+    EXPECT(got == want && n == wn && (!got || memcmp(d16, ref_a, 2 * n) == 0), "neon_utf8_to_utf16");
+    uint32_t* d32 = (uint32_t*)tail(1, 4 * len);
+    got = neon_utf8_to_utf32((const char*)s, len, d32, &n);
+    want = ref_utf8_to_utf32(data, len, (uint32_t*)ref_a, &wn);
+    EXPECT(got == want && n == wn && (!got || memcmp(d32, ref_a, 4 * n) == 0), "neon_utf8_to_utf32");
+
+    // The raw bytes as UTF-16 units
+    size_t units = len / 2;
+    uint16_t* s16 = (uint16_t*)tail(2, 2 * units);
+    memcpy(s16, data, 2 * units);
+    got = neon_utf16_to_utf8(s16, units, (char*)tail(1, 3 * units), &n);
+    want = ref_utf16_to_utf8(s16, units, ref_a, &wn);
+    EXPECT(got == want && n == wn && (!got || memcmp(tail(1, 3 * units), ref_a, n) == 0), "neon_utf16_to_utf8");
+
+    // Streaming validation, split every (param + 1) bytes
+    neon_utf8_stream_t st;
+    neon_utf8_stream_init(&st);
+    for (size_t i = 0; i < len; i += (size_t)param + 1) {
+        size_t k = len - i < (size_t)param + 1 ? len - i : (size_t)param + 1;
+        neon_utf8_stream_update(&st, (const char*)s + i, k);
+    }
+    EXPECT(neon_utf8_stream_finish(&st) == ref_utf8_validate(data, len, &off), "neon_utf8_stream");
+
+    // Batch and column entry points: the data cut into strings whose
+    // lengths come from the data itself
+    static const char* strs[MAX_INPUT + 1];
+    static char* wstrs[MAX_INPUT + 1];
+    static size_t lens[MAX_INPUT + 1];
+    static int32_t offsets[MAX_INPUT + 2];
+    static uint8_t bits[MAX_INPUT / 8 + 2], colbits[MAX_INPUT / 8 + 2];
+    size_t nstr = 0;
+    offsets[0] = 0;
+    for (size_t i = 0; i < len || nstr == 0;) {
+        // Empty strings included; the last one takes whatever is left
+        size_t k = len - i;
+        if (nstr < MAX_INPUT && len) {
+            size_t pick = (data[nstr % len] ^ param) % 24;
+            k = pick < k ? pick : k;
+        }
+        strs[nstr] = (const char*)s + i;
+        wstrs[nstr] = (char*)s + i;
+        lens[nstr] = k;
+        offsets[nstr + 1] = (int32_t)(i + k);
+        nstr++;
+        i += k;
+    }
+    neon_utf8_validate_batch(strs, lens, nstr, bits);
+    neon_utf8_validate_column((const char*)s, offsets, nstr, colbits);
+    for (size_t i = 0; i < nstr; i++) {
+        int ok = ref_utf8_validate(data + offsets[i], lens[i], &off);
+        EXPECT(((bits[i / 8] >> i % 8) & 1) == ok, "neon_utf8_validate_batch");
+        EXPECT(((colbits[i / 8] >> i % 8) & 1) == ok, "neon_utf8_validate_column");
+    }
+    neon_to_upper_batch(wstrs, lens, nstr);
+    for (size_t i = 0; i < len; i++) {
+        EXPECT(s[i] == ref_upper(data[i]), "neon_to_upper_batch");
+    }
+    neon_to_lower_column((char*)s, offsets, nstr);
+    for (size_t i = 0; i < len; i++) {
+        EXPECT(s[i] == ref_lower(data[i]), "neon_to_lower_column");
+    }
+    memcpy(s, data, len);
+
+    // Base64 round trip, then the data itself as base64 text
+    n = neon_base64_encode((const char*)s, len, (char*)tail(1, (len + 2) / 3 * 4));
+    wn = ref_base64_encode(data, len, ref_a);
+    EXPECT(n == wn && memcmp(tail(1, n), ref_a, n) == 0, "neon_base64_encode");
+    got = neon_base64_decode((const char*)s, len, (char*)tail(1, len / 4 * 3), &n);
+    want = ref_base64_decode(data, len, ref_b, &wn);
+    EXPECT(got == want && n == wn && (!got || memcmp(tail(1, len / 4 * 3), ref_b, n) == 0),
+           "neon_base64_decode");
+    int utf8 = -1;
+    got = neon_base64_decode_utf8((const char*)s, len, (char*)tail(1, len / 4 * 3), &n, &utf8);
+    EXPECT(got == want && n == wn && utf8 == (want && ref_utf8_validate(ref_b, wn, &off)),
+           "neon_base64_decode_utf8");
+
+    // Search: bytes and needles taken from the data
+    uint8_t set[3] = { param, len ? data[len / 2] : 0, len ? data[len - 1] : 0 };
+    EXPECT(neon_memchr((const char*)s, len, set[0]) == ref_memchr_set(data, len, set, 1), "neon_memchr");
+    EXPECT(neon_memchr2((const char*)s, len, set[0], set[1]) == ref_memchr_set(data, len, set, 2), "neon_memchr2");
+    EXPECT(neon_memchr3((const char*)s, len, set[0], set[1], set[2]) == ref_memchr_set(data, len, set, 3),
+           "neon_memchr3");
+    size_t m = (size_t)(param & 0x3F) < len ? (size_t)(param & 0x3F) : len;
+    uint8_t* needle = tail(2, m);
+    memcpy(needle, data + (len - m) / 2, m);
+    if (m && (param & 0x40)) {
+        needle[m - 1] ^= 0x20;                  // Case flip or near miss
+    }
+    EXPECT(neon_find((const char*)s, len, (const char*)needle, m) == ref_find(data, len, needle, m, 0), "neon_find");
+    EXPECT(neon_find_nocase((const char*)s, len, (const char*)needle, m) == ref_find(data, len, needle, m, 1),
+           "neon_find_nocase");
+
+    // Delimiters: the first (param % 16) + 1 data bytes
+    neon_delim_set_t ds;
+    size_t count = len < (size_t)(param % 16) + 1 ? len : (size_t)(param % 16) + 1;
+    if (count > 0 && neon_delim_set_init(&ds, (const char*)data, count)) {
+        uint32_t* offs = (uint32_t*)tail(1, 4 * len);
+        n = neon_delim_offsets((const char*)s, len, &ds, offs, NULL);
+        size_t k = 0;
+        for (size_t i = 0; i < len; i++) {
+            if (ref_memchr_set(data + i, 1, data, count) == 0) {
+                EXPECT(k < n && offs[k] == i, "neon_delim_offsets");
+                k++;
+            }
+        }
+        EXPECT(k == n, "neon_delim_offsets");
+        uint64_t* bits = (uint64_t*)tail(2, (len + 63) / 64 * 8);
+        neon_delim_bitmap((const char*)s, len, &ds, bits, NULL);
+        for (size_t i = 0; i < len; i++) {
+            EXPECT((int)(bits[i / 64] >> (i % 64) & 1) == (ref_memchr_set(data + i, 1, data, count) == 0),
+                   "neon_delim_bitmap");
+        }
+    }
+
+    // Whitespace
+    n = neon_trim_copy((char*)dst, (const char*)s, len);
+    wn = ref_trim(ref_a, data, len, 0);
+    EXPECT(n == wn && memcmp(dst, ref_a, n) == 0, "neon_trim_copy");
+    n = neon_trim((char*)s, len);
+    EXPECT(n == wn && memcmp(s, ref_a, n) == 0, "neon_trim");
+    memcpy(s, data, len);
+    n = neon_trim_lower_copy((char*)dst, (const char*)s, len);
+    wn = ref_trim(ref_a, data, len, 1);
+    EXPECT(n == wn && memcmp(dst, ref_a, n) == 0, "neon_trim_lower_copy");
+    n = neon_trim_lower((char*)s, len);
+    EXPECT(n == wn && memcmp(s, ref_a, n) == 0, "neon_trim_lower");
+    memcpy(s, data, len);
+    n = neon_collapse_whitespace_copy((char*)dst, (const char*)s, len);
+    wn = ref_collapse_whitespace(ref_a, data, len);
+    EXPECT(n == wn && memcmp(dst, ref_a, n) == 0, "neon_collapse_whitespace_copy");
+    n = neon_collapse_whitespace((char*)s, len);
+    EXPECT(n == wn && memcmp(s, ref_a, n) == 0, "neon_collapse_whitespace");
+    memcpy(s, data, len);
+    n = neon_strip_control((char*)s, len);
+    wn = ref_strip_control(ref_a, data, len);
+    EXPECT(n == wn && memcmp(s, ref_a, n) == 0, "neon_strip_control");
+    memcpy(s, data, len);
+
+    // Numbers
+    uint64_t v = 0, wv = 0;
+    got = neon_parse_u64((const char*)s, len, &v, &n);
+    want = ref_parse_u64(data, len, &wv, &wn);
+    EXPECT(got == want && n == wn && (!got || v == wv), "neon_parse_u64");
+    got = neon_hex_decode((const char*)s, len, (char*)tail(1, len / 2), &n);
+    want = ref_hex_decode(data, len, ref_a, &wn);
+    EXPECT(got == want && n == wn && (!got || memcmp(tail(1, len / 2), ref_a, len / 2) == 0), "neon_hex_decode");
+    n = neon_hex_encode((const char*)s, len, (char*)tail(1, 2 * len), param & 1);
+    ref_hex_encode(data, len, ref_a, param & 1);
+    EXPECT(n == 2 * len && memcmp(tail(1, n), ref_a, n) == 0, "neon_hex_encode");
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (!region_end[0]) {
+        regions_init();
+    }
+    if (size == 0) {
+        return 0;
+    }
+    uint8_t param = data[0];
+    size_t len = size - 1 < MAX_INPUT ? size - 1 : MAX_INPUT;
+    memcpy(tail(0, len), data + 1, len);
+    fuzz_case(data + 1, len, param);
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+static int run_file(FILE* f) {
+    static uint8_t buf[MAX_INPUT + 1];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    return LLVMFuzzerTestOneInput(buf, n);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return run_file(stdin);
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE* f = fopen(argv[i], "rb");
+        if (!f) {
+            perror(argv[i]);
+            return 1;
+        }
+        run_file(f);
+        fclose(f);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,444 @@
+// Scalar reference implementations for the differential tests
+// (test_differential.c) and the fuzz target (fuzz_kernels.c)
+//
+// One byte or code unit at a time, written to be obviously correct rather
+// than fast; each follows the contract in arm_string_ops.h, including the
+// error offsets. See docs/TESTING.md.
+
+#ifndef ARM_STRING_OPS_REFERENCE_H
+#define ARM_STRING_OPS_REFERENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "case_reference.h"
+
+static inline int ref_is_upper(uint8_t c) { return c >= 'A' && c <= 'Z'; }
+static inline int ref_is_lower(uint8_t c) { return c >= 'a' && c <= 'z'; }
+static inline uint8_t ref_upper(uint8_t c) { return ref_is_lower(c) ? (uint8_t)(c - 32) : c; }
+static inline uint8_t ref_lower(uint8_t c) { return ref_is_upper(c) ? (uint8_t)(c + 32) : c; }
+static inline int ref_is_space(uint8_t c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+static inline int ref_is_control(uint8_t c) { return (c < 0x20 && !ref_is_space(c)) || c == 0x7F; }
+
+// memcmp of the lowercased bytes, reduced to -1, 0 or 1
+static inline int ref_casecmp(const uint8_t* a, const uint8_t* b, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uint8_t x = ref_lower(a[i]), y = ref_lower(b[i]);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// CRC32C (Castagnoli, reflected) of the lowercased bytes
+static inline uint32_t ref_hash_lower(const uint8_t* s, size_t len, uint32_t seed) {
+    uint32_t crc = ~seed;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= ref_lower(s[i]);
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// UTF-8 (RFC 3629). Returns the length of the complete, valid sequence at p
+// with *cp = its code point, or 0; *subpart (may be NULL) then receives the
+// length of the maximal subpart: the lead byte and the continuation bytes
+// that are still acceptable after it (at least 1)
+static inline size_t ref_utf8_decode(const uint8_t* p, size_t n, uint32_t* cp, size_t* subpart) {
+    uint8_t c = p[0];
+    size_t need;
+    uint32_t v;
+    uint8_t lo = 0x80, hi = 0xBF;
+    if (subpart) {
+        *subpart = 1;
+    }
+    if (c < 0x80) {
+        *cp = c;
+        return 1;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        need = 2;
+        v = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        need = 3;
+        v = c & 0x0F;
+        lo = c == 0xE0 ? 0xA0 : 0x80;
+        hi = c == 0xED ? 0x9F : 0xBF;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        need = 4;
+        v = c & 0x07;
+        lo = c == 0xF0 ? 0x90 : 0x80;
+        hi = c == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+    for (size_t i = 1; i < need; i++) {
+        if (i >= n || p[i] < lo || p[i] > hi) {
+            if (subpart) {
+                *subpart = i;
+            }
+            return 0;
+        }
+        v = (v << 6) | (p[i] & 0x3F);
+        lo = 0x80;
+        hi = 0xBF;
+    }
+    *cp = v;
+    return need;
+}
+
+// 1 if valid; *offset = start of the first invalid sequence, or len
+static inline int ref_utf8_validate(const uint8_t* s, size_t len, size_t* offset) {
+    uint32_t cp;
+    size_t i = 0;
+    while (i < len) {
+        size_t k = ref_utf8_decode(s + i, len - i, &cp, NULL);
+        if (k == 0) {
+            *offset = i;
+            return 0;
+        }
+        i += k;
+    }
+    *offset = len;
+    return 1;
+}
+
+// Bytes that are not continuation bytes (the character count of valid input)
+static inline size_t ref_count_chars(const uint8_t* s, size_t len) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        n += (s[i] & 0xC0) != 0x80;
+    }
+    return n;
+}
+
+static inline int ref_is_ascii(const uint8_t* s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] >= 0x80) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// U+FFFD for every maximal invalid subpart
+static inline size_t ref_utf8_sanitize(uint8_t* dst, const uint8_t* src, size_t len) {
+    size_t i = 0, o = 0, sub;
+    uint32_t cp;
+    while (i < len) {
+        size_t k = ref_utf8_decode(src + i, len - i, &cp, &sub);
+        if (k) {
+            memcpy(dst + o, src + i, k);
+            o += k;
+            i += k;
+        } else {
+            memcpy(dst + o, "\xEF\xBF\xBD", 3);
+            o += 3;
+            i += sub;
+        }
+    }
+    return o;
+}
+
+static inline int ref_utf8_to_utf16(const uint8_t* s, size_t len, uint16_t* dst, size_t* out_len) {
+    size_t i = 0, o = 0;
+    uint32_t cp;
+    while (i < len) {
+        size_t k = ref_utf8_decode(s + i, len - i, &cp, NULL);
+        if (k == 0) {
+            *out_len = i;
+            return 0;
+        }
+        if (cp >= 0x10000) {
+            dst[o++] = (uint16_t)(0xD800 + ((cp - 0x10000) >> 10));
+            dst[o++] = (uint16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        } else {
+            dst[o++] = (uint16_t)cp;
+        }
+        i += k;
+    }
+    *out_len = o;
+    return 1;
+}
+
+static inline int ref_utf8_to_utf32(const uint8_t* s, size_t len, uint32_t* dst, size_t* out_len) {
+    size_t i = 0, o = 0;
+    uint32_t cp;
+    while (i < len) {
+        size_t k = ref_utf8_decode(s + i, len - i, &cp, NULL);
+        if (k == 0) {
+            *out_len = i;
+            return 0;
+        }
+        dst[o++] = cp;
+        i += k;
+    }
+    *out_len = o;
+    return 1;
+}
+
+// Simple case mapping of one code point (test/case_reference.h)
+static inline uint32_t ref_case_map(uint32_t cp, int upper) {
+    const uint32_t (*map)[2] = upper ? ref_case_upper_map : ref_case_lower_map;
+    size_t lo = 0, hi = upper ? sizeof(ref_case_upper_map) / sizeof(ref_case_upper_map[0])
+                              : sizeof(ref_case_lower_map) / sizeof(ref_case_lower_map[0]);
+    if (cp < 0x80) {
+        return upper ? ref_upper((uint8_t)cp) : ref_lower((uint8_t)cp);
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (map[mid][0] == cp) {
+            return map[mid][1];
+        }
+        if (map[mid][0] < cp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return cp;
+}
+
+// neon_utf8_to_upper/lower: each valid character mapped and re-encoded,
+// each byte that does not start one copied
+static inline size_t ref_utf8_case(uint8_t* dst, const uint8_t* s, size_t len, int upper) {
+    size_t i = 0, o = 0;
+    uint32_t cp;
+    while (i < len) {
+        size_t k = ref_utf8_decode(s + i, len - i, &cp, NULL);
+        if (k == 0) {
+            dst[o++] = s[i++];
+            continue;
+        }
+        cp = ref_case_map(cp, upper);
+        if (cp < 0x80) {
+            dst[o++] = (uint8_t)cp;
+        } else if (cp < 0x800) {
+            dst[o++] = (uint8_t)(0xC0 | cp >> 6);
+            dst[o++] = (uint8_t)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            dst[o++] = (uint8_t)(0xE0 | cp >> 12);
+            dst[o++] = (uint8_t)(0x80 | (cp >> 6 & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | (cp & 0x3F));
+        } else {
+            dst[o++] = (uint8_t)(0xF0 | cp >> 18);
+            dst[o++] = (uint8_t)(0x80 | (cp >> 12 & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | (cp >> 6 & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | (cp & 0x3F));
+        }
+        i += k;
+    }
+    return o;
+}
+
+static inline int ref_utf16_to_utf8(const uint16_t* s, size_t len, uint8_t* dst, size_t* out_len) {
+    size_t o = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint32_t c = s[i];
+        if (c >= 0xD800 && c <= 0xDFFF) {
+            if (c >= 0xDC00 || i + 1 >= len || s[i + 1] < 0xDC00 || s[i + 1] > 0xDFFF) {
+                *out_len = i;
+                return 0;
+            }
+            c = 0x10000 + ((c - 0xD800) << 10) + (s[++i] - 0xDC00u);
+        }
+        if (c < 0x80) {
+            dst[o++] = (uint8_t)c;
+        } else if (c < 0x800) {
+            dst[o++] = (uint8_t)(0xC0 | (c >> 6));
+            dst[o++] = (uint8_t)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            dst[o++] = (uint8_t)(0xE0 | (c >> 12));
+            dst[o++] = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | (c & 0x3F));
+        } else {
+            dst[o++] = (uint8_t)(0xF0 | (c >> 18));
+            dst[o++] = (uint8_t)(0x80 | ((c >> 12) & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+            dst[o++] = (uint8_t)(0x80 | (c & 0x3F));
+        }
+    }
+    *out_len = o;
+    return 1;
+}
+
+// Base64 (RFC 4648, '=' padding)
+static const char ref_base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static inline int ref_base64_value(uint8_t c) {
+    const char* p = c ? strchr(ref_base64_alphabet, c) : NULL;
+    return p ? (int)(p - ref_base64_alphabet) : -1;
+}
+
+static inline size_t ref_base64_encode(const uint8_t* s, size_t len, uint8_t* dst) {
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)s[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)s[i + 1] << 8;
+        if (i + 2 < len) v |= s[i + 2];
+        dst[o++] = (uint8_t)ref_base64_alphabet[v >> 18];
+        dst[o++] = (uint8_t)ref_base64_alphabet[(v >> 12) & 63];
+        dst[o++] = i + 1 < len ? (uint8_t)ref_base64_alphabet[(v >> 6) & 63] : '=';
+        dst[o++] = i + 2 < len ? (uint8_t)ref_base64_alphabet[v & 63] : '=';
+    }
+    return o;
+}
+
+// 1 with *out_len = bytes written, or 0 with *out_len = offset of the first
+// character that is not valid at its position (the start of an incomplete
+// last group if every character is)
+static inline int ref_base64_decode(const uint8_t* s, size_t len, uint8_t* dst, size_t* out_len) {
+    size_t full = len & ~(size_t)3;
+    for (size_t i = 0; i < full; i++) {
+        if (ref_base64_value(s[i]) >= 0) {
+            continue;
+        }
+        int pad_ok = s[i] == '=' && full == len &&
+                     (i == len - 1 || (i == len - 2 && s[len - 1] == '='));
+        if (!pad_ok) {
+            *out_len = i;
+            return 0;
+        }
+    }
+    if (full != len) {
+        *out_len = full;
+        return 0;
+    }
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 4) {
+        uint32_t v = 0;
+        int pad = 0;
+        for (int k = 0; k < 4; k++) {
+            int d = ref_base64_value(s[i + k]);
+            pad += d < 0;
+            v = (v << 6) | (uint32_t)(d < 0 ? 0 : d);
+        }
+        dst[o++] = (uint8_t)(v >> 16);
+        if (pad < 2) dst[o++] = (uint8_t)(v >> 8);
+        if (pad < 1) dst[o++] = (uint8_t)v;
+    }
+    *out_len = o;
+    return 1;
+}
+
+// Search: offset of the first match, or len
+static inline size_t ref_memchr_set(const uint8_t* s, size_t len, const uint8_t* set, size_t n) {
+    for (size_t i = 0; i < len; i++) {
+        for (size_t k = 0; k < n; k++) {
+            if (s[i] == set[k]) {
+                return i;
+            }
+        }
+    }
+    return len;
+}
+
+static inline size_t ref_find(const uint8_t* h, size_t len, const uint8_t* n, size_t m, int nocase) {
+    if (m == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i + m <= len; i++) {
+        if (nocase ? ref_casecmp(h + i, n, m) == 0 : memcmp(h + i, n, m) == 0) {
+            return i;
+        }
+    }
+    return len;
+}
+
+// Whitespace operations; each returns the new length
+static inline size_t ref_trim(uint8_t* dst, const uint8_t* s, size_t len, int lower) {
+    size_t b = 0, e = len;
+    while (b < e && ref_is_space(s[b])) b++;
+    while (e > b && ref_is_space(s[e - 1])) e--;
+    for (size_t i = b; i < e; i++) {
+        dst[i - b] = lower ? ref_lower(s[i]) : s[i];
+    }
+    return e - b;
+}
+
+static inline size_t ref_collapse_whitespace(uint8_t* dst, const uint8_t* s, size_t len) {
+    size_t o = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!ref_is_space(s[i])) {
+            dst[o++] = s[i];
+        } else if (i == 0 || !ref_is_space(s[i - 1])) {
+            dst[o++] = ' ';
+        }
+    }
+    return o;
+}
+
+static inline size_t ref_strip_control(uint8_t* dst, const uint8_t* s, size_t len) {
+    size_t o = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!ref_is_control(s[i])) {
+            dst[o++] = s[i];
+        }
+    }
+    return o;
+}
+
+// Numbers
+static inline int ref_parse_u64(const uint8_t* s, size_t len, uint64_t* value, size_t* offset) {
+    if (len == 0) {
+        *offset = 0;
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            *offset = i;
+            return 0;
+        }
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint64_t d = s[i] - '0';
+        if (v > (UINT64_MAX - d) / 10) {
+            *offset = i;
+            return 0;
+        }
+        v = v * 10 + d;
+    }
+    *value = v;
+    *offset = len;
+    return 1;
+}
+
+static inline int ref_hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static inline int ref_hex_decode(const uint8_t* s, size_t len, uint8_t* dst, size_t* offset) {
+    for (size_t i = 0; i < len; i++) {
+        if (ref_hex_value(s[i]) < 0) {
+            *offset = i;
+            return 0;
+        }
+    }
+    if (len % 2) {
+        *offset = len - 1;
+        return 0;
+    }
+    for (size_t i = 0; i < len; i += 2) {
+        dst[i / 2] = (uint8_t)(ref_hex_value(s[i]) << 4 | ref_hex_value(s[i + 1]));
+    }
+    *offset = len;
+    return 1;
+}
+
+static inline size_t ref_hex_encode(const uint8_t* s, size_t len, uint8_t* dst, int upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        dst[2 * i] = (uint8_t)digits[s[i] >> 4];
+        dst[2 * i + 1] = (uint8_t)digits[s[i] & 15];
+    }
+    return 2 * len;
+}
+
+#endif
@@ -0,0 +1,20 @@
+// C entry points into simdutf for test/benchmark.c (built with SIMDUTF=1)
+#include <cstddef>
+#include <cstdint>
+#include <simdutf.h>
+
+extern "C" {
+
+int simdutf_shim_validate_utf8(const char* str, size_t len) {
+    return simdutf::validate_utf8(str, len) ? 1 : 0;
+}
+
+size_t simdutf_shim_count_utf8(const char* str, size_t len) {
+    return simdutf::count_utf8(str, len);
+}
+
+size_t simdutf_shim_utf8_to_utf16(const char* str, size_t len, uint16_t* dst) {
+    return simdutf::convert_utf8_to_utf16le(str, len, reinterpret_cast<char16_t*>(dst));
+}
+
+}
@@ -0,0 +1,758 @@
+// Differential tests: every kernel against the scalar references in
+// reference.h, for every length 0-256 at every alignment 0-63
+//
+// Each (length, alignment) pair runs with several input families (ASCII
+// text, valid UTF-8, UTF-8 with one corrupted byte, random bytes and bytes
+// around the class boundaries the kernels compare against), plus once more
+// with the input ending at a PROT_NONE page, so a read past the end faults.
+// Output buffers end at a guard page too: a write past the documented size
+// faults, and the signal handler names the case that caused it.
+//
+//   make test-diff                           # all kernels
+//   build/test_differential find utf8        # kernels whose name contains a word
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#include "arm_string_ops.h"
+#include "reference.h"
+
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+
+#define MAX_LEN     256
+#define MAX_ALIGN   64          // Alignments 0-63, then the end-of-page run
+#define MODES       5
+#define REGION_SIZE (64 * 1024)
+
+// A read/write region between two PROT_NONE pages
+typedef struct {
+    uint8_t* start;
+    uint8_t* end;
+} region_t;
+
+static region_t src_region, dst_region, aux_region;
+
+// Case being run, for failure and crash reports
+static const char* cur_kernel = "";
+static size_t cur_len, cur_align;
+static int cur_mode;
+static const uint8_t* cur_input;
+
+static void region_init(region_t* r) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (REGION_SIZE + page - 1) / page * page;
+    uint8_t* p = mmap(NULL, size + 2 * page, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        exit(2);
+    }
+    mprotect(p, page, PROT_NONE);
+    mprotect(p + page + size, page, PROT_NONE);
+    r->start = p + page;
+    r->end = p + page + size;
+}
+
+// len bytes at the given alignment from the start of the region, or ending
+// at its end when align == MAX_ALIGN
+static uint8_t* place(const region_t* r, size_t len, size_t align) {
+    return align == MAX_ALIGN ? r->end - len : r->start + align;
+}
+
+// Space for cap bytes that ends at the guard page
+static uint8_t* out_buf(const region_t* r, size_t cap) {
+    return r->end - cap;
+}
+
+static void dump_case(void) {
+    fprintf(stderr, "  kernel %s, len %zu, %s %zu, input family %d\n  input:", cur_kernel, cur_len,
+            cur_align == MAX_ALIGN ? "ending at a guard page, align" : "align",
+            cur_align == MAX_ALIGN ? (size_t)(uintptr_t)(src_region.end - cur_len) % 64 : cur_align,
+            cur_mode);
+    for (size_t i = 0; cur_input && i < cur_len; i++) {
+        fprintf(stderr, "%s%02x", i % 32 ? " " : "\n    ", cur_input[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+static void on_fault(int sig) {
+    fprintf(stderr, "\n✗ %s outside its buffers\n", sig == SIGSEGV ? "Access" : "Bus error on access");
+    dump_case();
+    _exit(1);
+}
+
+// xorshift64*, seeded per case so every failure is reproducible
+static uint64_t rng_state;
+
+static uint32_t rnd(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Input family `mode` of len bytes
+static void generate(uint8_t* out, size_t len, int mode) {
+    static const char text[] = "The Quick brown FOX, 0123456789 ZZzz@[`{\t\r\n";
+    static const char* chars[] = { "a", "Z", "7", " ", "\xc3\xa9", "\xdf\xbf", "\xe2\x82\xac",
+                                   "\xed\x9f\xbf", "\xef\xbf\xbd", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf",
+                                   // Case pairs of the vectorized rows (Latin, Greek, Cyrillic)
+                                   "\xc3\x89", "\xc3\xbf", "\xc4\x80", "\xc4\xb1", "\xc5\xbf",
+                                   "\xce\x86", "\xce\xa3", "\xce\xb1", "\xcf\x82", "\xcf\x89",
+                                   "\xd0\x80", "\xd0\xaf", "\xd0\xb0", "\xd1\x80", "\xd1\x8f",
+                                   "\xd1\x90", "\xd1\xa0", "\xd2\x8a", "\xd3\x81", "\xd3\xbf",
+                                   NULL, NULL };  // NULL: any two-byte character, lead C3-D3
+    static const uint8_t edges[] = { 0x00, 0x09, 0x0d, 0x1f, ' ', '+', '/', '0', '9', ':', '=', '@', 'A',
+                                     'F', 'Z', '[', '`', 'a', 'f', 'z', '{', 0x7f, 0x80, 0x8f, 0x90, 0x9f,
+                                     0xa0, 0xbf, 0xc0, 0xc1, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4,
+                                     0xf5, 0xff };
+    size_t i = 0;
+    switch (mode) {
+    case 0:
+        for (; i < len; i++) {
+            out[i] = (uint8_t)text[rnd() % (sizeof(text) - 1)];
+        }
+        break;
+    case 1:
+    case 2:
+        while (i < len) {
+            const char* c = chars[rnd() % (sizeof(chars) / sizeof(chars[0]))];
+            char two[3] = { (char)(0xC3 + rnd() % 17), (char)(0x80 + rnd() % 64), 0 };
+            if (c == NULL) {
+                c = two;
+            }
+            size_t n = strlen(c);
+            if (i + n > len) {
+                n = rnd() % 4 == 0 ? len - i : 0;   // Sometimes end inside a character
+                if (n == 0) {
+                    out[i++] = 'x';
+                    continue;
+                }
+            }
+            memcpy(out + i, c, n);
+            i += n;
+        }
+        if (mode == 2 && len > 0) {
+            out[rnd() % len] = edges[rnd() % sizeof(edges)];
+        }
+        break;
+    case 3:
+        for (; i < len; i++) {
+            out[i] = (uint8_t)rnd();
+        }
+        break;
+    default:
+        for (; i < len; i++) {
+            out[i] = edges[rnd() % sizeof(edges)];
+        }
+        break;
+    }
+}
+
+// A check runs one kernel on buf (len bytes, a copy of orig it may modify)
+// and returns 0 on a mismatch, after printing what differed
+typedef int (*check_fn)(uint8_t* buf, const uint8_t* orig, size_t len);
+
+#define CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "\n✗ " __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+            return 0; \
+        } \
+    } while (0)
+
+static size_t case_count;
+
+static int run(const char* name, check_fn fn) {
+    static uint8_t orig[MAX_LEN];
+    cur_kernel = name;
+    for (size_t len = 0; len <= MAX_LEN; len++) {
+        for (size_t align = 0; align <= MAX_ALIGN; align++) {
+            for (int mode = 0; mode < MODES; mode++) {
+                rng_state = 0x9E3779B97F4A7C15ULL ^ (len << 32 | align << 8 | (size_t)mode);
+                generate(orig, len, mode);
+                uint8_t* buf = place(&src_region, len, align);
+                memcpy(buf, orig, len);
+                cur_len = len;
+                cur_align = align;
+                cur_mode = mode;
+                cur_input = orig;
+                if (!fn(buf, orig, len)) {
+                    dump_case();
+                    return 0;
+                }
+                case_count++;
+            }
+        }
+    }
+    printf("✓ %s\n", name);
+    return 1;
+}
+
+// Case conversion
+
+typedef void (*case_fn)(char*, size_t);
+
+static int check_case(uint8_t* buf, const uint8_t* orig, size_t len, case_fn fn, int upper) {
+    fn((char*)buf, len);
+    for (size_t i = 0; i < len; i++) {
+        uint8_t want = upper ? ref_upper(orig[i]) : ref_lower(orig[i]);
+        CHECK(buf[i] == want, "byte %zu is %02x, expected %02x", i, buf[i], want);
+    }
+    return 1;
+}
+
+static int check_upper(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_upper, 1); }
+static int check_lower(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_lower, 0); }
+static int check_upper_asimd(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_upper_asimd, 1); }
+static int check_lower_asimd(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_lower_asimd, 0); }
+static int check_upper_sve(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_upper_sve, 1); }
+static int check_lower_sve(uint8_t* b, const uint8_t* o, size_t n) { return check_case(b, o, n, neon_to_lower_sve, 0); }
+
+static int check_case_copy(uint8_t* buf, const uint8_t* orig, size_t len) {
+    uint8_t* dst = out_buf(&dst_region, len);
+    for (int upper = 0; upper < 2; upper++) {
+        (upper ? neon_to_upper_copy : neon_to_lower_copy)((char*)dst, (const char*)buf, len);
+        CHECK(memcmp(buf, orig, len) == 0, "_copy modified its source");
+        for (size_t i = 0; i < len; i++) {
+            uint8_t want = upper ? ref_upper(orig[i]) : ref_lower(orig[i]);
+            CHECK(dst[i] == want, "%s_copy byte %zu is %02x, expected %02x",
+                  upper ? "to_upper" : "to_lower", i, dst[i], want);
+        }
+    }
+    return 1;
+}
+
+static int check_casecmp_hash(uint8_t* buf, const uint8_t* orig, size_t len) {
+    // Compare against a case-swapped copy with at most one changed byte
+    uint8_t* other = out_buf(&dst_region, len);
+    for (size_t i = 0; i < len; i++) {
+        other[i] = ref_is_upper(orig[i]) ? ref_lower(orig[i]) : ref_upper(orig[i]);
+    }
+    if (len > 0 && rnd() % 2) {
+        other[rnd() % len] = (uint8_t)rnd();
+    }
+    int got = neon_ascii_casecmp((const char*)buf, (const char*)other, len);
+    int want = ref_casecmp(buf, other, len);
+    CHECK((got > 0) - (got < 0) == want, "neon_ascii_casecmp returned %d, expected sign %d", got, want);
+    uint32_t seed = rnd();
+    uint32_t h = neon_hash_lower((const char*)buf, len, seed);
+    CHECK(h == ref_hash_lower(orig, len, seed), "neon_hash_lower returned %08x, expected %08x",
+          h, ref_hash_lower(orig, len, seed));
+    return 1;
+}
+
+// Unicode case conversion against the generated mapping (case_reference.h),
+// out of place and in place
+static int check_utf8_case(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint8_t want[MAX_LEN];
+    uint8_t* dst = out_buf(&dst_region, len);
+    for (int upper = 0; upper < 2; upper++) {
+        const char* name = upper ? "upper" : "lower";
+        size_t wn = ref_utf8_case(want, orig, len, upper);
+        size_t n = (upper ? neon_utf8_to_upper : neon_utf8_to_lower)((char*)dst, (const char*)buf, len);
+        CHECK(n == wn, "neon_utf8_to_%s wrote %zu bytes, expected %zu", name, n, wn);
+        for (size_t i = 0; i < n; i++) {
+            CHECK(dst[i] == want[i], "neon_utf8_to_%s byte %zu is %02x, expected %02x", name, i,
+                  dst[i], want[i]);
+        }
+        n = (upper ? neon_utf8_to_upper : neon_utf8_to_lower)((char*)buf, (const char*)buf, len);
+        CHECK(n == wn && memcmp(buf, want, n) == 0, "neon_utf8_to_%s in place differs", name);
+        memcpy(buf, orig, len);
+    }
+    return 1;
+}
+
+// UTF-8
+
+typedef int (*validate_fn)(const char*, size_t);
+typedef size_t (*count_fn)(const char*, size_t);
+
+static int check_validate_with(const uint8_t* buf, const uint8_t* orig, size_t len,
+                               validate_fn validate, count_fn count) {
+    size_t off;
+    int want = ref_utf8_validate(orig, len, &off);
+    int got = validate((const char*)buf, len);
+    CHECK(got == want, "validation returned %d, expected %d (first error at %zu)", got, want, off);
+    size_t chars = count((const char*)buf, len);
+    CHECK(chars == ref_count_chars(orig, len), "count returned %zu, expected %zu", chars,
+          ref_count_chars(orig, len));
+    return 1;
+}
+
+static int check_validate(uint8_t* b, const uint8_t* o, size_t n) {
+    return check_validate_with(b, o, n, neon_utf8_validate, neon_utf8_count_chars);
+}
+static int check_validate_asimd(uint8_t* b, const uint8_t* o, size_t n) {
+    return check_validate_with(b, o, n, neon_utf8_validate_asimd, neon_utf8_count_chars_asimd);
+}
+static int check_validate_sve(uint8_t* b, const uint8_t* o, size_t n) {
+    return check_validate_with(b, o, n, neon_utf8_validate_sve, neon_utf8_count_chars_sve);
+}
+
+static int check_validate_variants(uint8_t* buf, const uint8_t* orig, size_t len) {
+    size_t off, got_off = 12345, chars = 12345;
+    int want = ref_utf8_validate(orig, len, &off);
+    int got = neon_utf8_validate_ex((const char*)buf, len, &got_off);
+    CHECK(got == want && got_off == off, "neon_utf8_validate_ex returned %d at %zu, expected %d at %zu",
+          got, got_off, want, off);
+    got = neon_utf8_validate_count((const char*)buf, len, &chars);
+    CHECK(got == want, "neon_utf8_validate_count returned %d, expected %d", got, want);
+    CHECK(!want || chars == ref_count_chars(orig, len), "neon_utf8_validate_count counted %zu, expected %zu",
+          chars, ref_count_chars(orig, len));
+    got = neon_is_ascii((const char*)buf, len);
+    CHECK(got == ref_is_ascii(orig, len), "neon_is_ascii returned %d", got);
+    return 1;
+}
+
+static int check_sanitize(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint8_t want[3 * MAX_LEN];
+    uint8_t* dst = out_buf(&dst_region, 3 * len);
+    size_t n = neon_utf8_sanitize((char*)dst, (const char*)buf, len);
+    size_t wn = ref_utf8_sanitize(want, orig, len);
+    CHECK(n == wn, "neon_utf8_sanitize wrote %zu bytes, expected %zu", n, wn);
+    CHECK(memcmp(dst, want, n) == 0, "neon_utf8_sanitize output differs");
+    return 1;
+}
+
+static int check_transcode(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint16_t want16[MAX_LEN];
+    static uint32_t want32[MAX_LEN];
+    size_t wn, n = 12345;
+    uint16_t* d16 = (uint16_t*)out_buf(&dst_region, 2 * len);
+    int want = ref_utf8_to_utf16(orig, len, want16, &wn);
+    int got = neon_utf8_to_utf16((const char*)buf, len, d16, &n);
+    CHECK(got == want && n == wn, "neon_utf8_to_utf16 returned %d with %zu, expected %d with %zu",
+          got, n, want, wn);
+    CHECK(!got || memcmp(d16, want16, 2 * n) == 0, "neon_utf8_to_utf16 output differs");
+
+    uint32_t* d32 = (uint32_t*)out_buf(&dst_region, 4 * len);
+    want = ref_utf8_to_utf32(orig, len, want32, &wn);
+    got = neon_utf8_to_utf32((const char*)buf, len, d32, &n);
+    CHECK(got == want && n == wn, "neon_utf8_to_utf32 returned %d with %zu, expected %d with %zu",
+          got, n, want, wn);
+    CHECK(!got || memcmp(d32, want32, 4 * n) == 0, "neon_utf8_to_utf32 output differs");
+    return 1;
+}
+
+// The input bytes read as len / 2 UTF-16 units, mostly made into
+// characters and surrogate pairs
+static int check_utf16_to_utf8(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint8_t ref_out[3 * MAX_LEN];
+    size_t units = len / 2;
+    uint16_t* src = (uint16_t*)place(&aux_region, 2 * units, cur_align == MAX_ALIGN ? MAX_ALIGN : cur_align & ~1u);
+    for (size_t i = 0; i < units; i++) {
+        uint16_t u = (uint16_t)(orig[2 * i] | orig[2 * i + 1] << 8);
+        int kind = orig[2 * i] % 8;
+        if (cur_mode == 3 || kind >= 5) {
+            src[i] = u;                             // Anything, unpaired surrogates too
+        } else if (kind >= 3 && i + 1 < units) {
+            src[i] = (uint16_t)(0xD800 | (u & 0x3FF));
+            src[i + 1] = (uint16_t)(0xDC00 | (orig[2 * i + 2] << 2));
+            i++;
+        } else {
+            src[i] = kind == 0 ? u & 0x7F : kind == 1 ? u & 0x7FF : (u & 0xD7FF);
+        }
+    }
+    (void)buf;
+    size_t wn, n = 12345;
+    uint8_t* dst = out_buf(&dst_region, 3 * units);
+    int want = ref_utf16_to_utf8(src, units, ref_out, &wn);
+    int got = neon_utf16_to_utf8(src, units, (char*)dst, &n);
+    CHECK(got == want && n == wn, "neon_utf16_to_utf8 returned %d with %zu, expected %d with %zu",
+          got, n, want, wn);
+    CHECK(!got || memcmp(dst, ref_out, n) == 0, "neon_utf16_to_utf8 output differs");
+    return 1;
+}
+
+// Chunked, batched and column validation split the same input at random
+static int check_stream(uint8_t* buf, const uint8_t* orig, size_t len) {
+    size_t off;
+    int want = ref_utf8_validate(orig, len, &off);
+    neon_utf8_stream_t st;
+    neon_utf8_stream_init(&st);
+    int ok_so_far = 1;
+    for (size_t i = 0; i < len;) {
+        size_t n = rnd() % 80;
+        if (n > len - i) {
+            n = len - i;
+        }
+        int r = neon_utf8_stream_update(&st, (const char*)buf + i, n);
+        CHECK(r || !want, "neon_utf8_stream_update reported an error in valid input at %zu", i);
+        CHECK(ok_so_far || !r, "neon_utf8_stream_update forgot an error");
+        ok_so_far = r;
+        i += n;
+    }
+    int got = neon_utf8_stream_finish(&st);
+    CHECK(got == want, "neon_utf8_stream_finish returned %d, expected %d", got, want);
+    return 1;
+}
+
+static int check_batch(uint8_t* buf, const uint8_t* orig, size_t len) {
+    const char* strs[MAX_LEN + 1];
+    size_t lens[MAX_LEN + 1];
+    int32_t offsets[MAX_LEN + 2];
+    uint8_t bits[MAX_LEN / 8 + 2], colbits[MAX_LEN / 8 + 2];
+    size_t n = 0;
+    offsets[0] = 0;
+    for (size_t i = 0; i < len || n == 0;) {
+        size_t k = rnd() % 4 ? rnd() % 8 : rnd() % 100;
+        if (k > len - i) {
+            k = len - i;
+        }
+        strs[n] = (const char*)buf + i;
+        lens[n] = k;
+        offsets[n + 1] = (int32_t)(i + k);
+        n++;
+        i += k;
+    }
+    memset(bits, 0xAA, sizeof(bits));
+    memset(colbits, 0x55, sizeof(colbits));
+    neon_utf8_validate_batch(strs, lens, n, bits);
+    neon_utf8_validate_column((const char*)buf, offsets, n, colbits);
+    for (size_t i = 0; i < (n + 7) / 8 * 8; i++) {
+        size_t off;
+        int want = i < n && ref_utf8_validate(orig + (strs[i] - (const char*)buf), lens[i], &off);
+        CHECK(((bits[i / 8] >> i % 8) & 1) == want, "neon_utf8_validate_batch bit %zu of %zu is wrong", i, n);
+        CHECK(((colbits[i / 8] >> i % 8) & 1) == want, "neon_utf8_validate_column bit %zu of %zu is wrong", i, n);
+    }
+
+    // The same split for in-place batch and column case conversion
+    char* wstrs[MAX_LEN + 1];
+    for (size_t i = 0; i < n; i++) {
+        wstrs[i] = (char*)strs[i];
+    }
+    neon_to_upper_batch(wstrs, lens, n);
+    for (size_t i = 0; i < len; i++) {
+        CHECK(buf[i] == ref_upper(orig[i]), "neon_to_upper_batch byte %zu is wrong", i);
+    }
+    neon_to_lower_column((char*)buf, offsets, n);
+    for (size_t i = 0; i < len; i++) {
+        CHECK(buf[i] == ref_lower(orig[i]), "neon_to_lower_column byte %zu is wrong", i);
+    }
+    return 1;
+}
+
+// Base64: encode the input, then decode encodings with a corrupted,
+// missing or extra character
+static int check_base64(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint8_t want[4 * MAX_LEN];
+    size_t elen = (len + 2) / 3 * 4;
+    uint8_t* enc = out_buf(&dst_region, elen);
+    size_t n = neon_base64_encode((const char*)buf, len, (char*)enc);
+    ref_base64_encode(orig, len, want);
+    CHECK(n == elen && memcmp(enc, want, n) == 0, "neon_base64_encode output differs");
+
+    size_t dlen = elen;
+    switch (cur_mode) {
+    case 2: if (dlen) want[rnd() % dlen] = (uint8_t)"= \n-_.*A\x00\xff"[rnd() % 10]; break;
+    case 3: if (dlen) dlen -= 1 + rnd() % (dlen < 3 ? dlen : 3); break;
+    case 4: want[dlen++] = '='; break;
+    default: break;
+    }
+    uint8_t* src = place(&aux_region, dlen, cur_align);
+    memcpy(src, want, dlen);
+    static uint8_t ref_out[3 * MAX_LEN];
+    size_t wn, got_n = 12345;
+    int utf8 = -1;
+    uint8_t* dec = out_buf(&dst_region, dlen / 4 * 3);
+    int w = ref_base64_decode(src, dlen, ref_out, &wn);
+    int got = neon_base64_decode((const char*)src, dlen, (char*)dec, &got_n);
+    CHECK(got == w && got_n == wn, "neon_base64_decode returned %d with %zu, expected %d with %zu",
+          got, got_n, w, wn);
+    CHECK(!got || memcmp(dec, ref_out, wn) == 0, "neon_base64_decode output differs");
+    got = neon_base64_decode_utf8((const char*)src, dlen, (char*)dec, &got_n, &utf8);
+    size_t off;
+    CHECK(got == w && got_n == wn, "neon_base64_decode_utf8 returned %d with %zu", got, got_n);
+    CHECK(utf8 == (w && ref_utf8_validate(ref_out, wn, &off)), "neon_base64_decode_utf8 UTF-8 flag is %d", utf8);
+    return 1;
+}
+
+// Search: byte sets taken from the input, needles cut out of it
+
+static int check_memchr(uint8_t* buf, const uint8_t* orig, size_t len) {
+    uint8_t set[3];
+    for (int k = 0; k < 3; k++) {
+        set[k] = len && rnd() % 4 ? orig[rnd() % len] : (uint8_t)rnd();
+    }
+    size_t got = neon_memchr((const char*)buf, len, set[0]);
+    CHECK(got == ref_memchr_set(orig, len, set, 1), "neon_memchr(%02x) returned %zu", set[0], got);
+    got = neon_memchr2((const char*)buf, len, set[0], set[1]);
+    CHECK(got == ref_memchr_set(orig, len, set, 2), "neon_memchr2 returned %zu", got);
+    got = neon_memchr3((const char*)buf, len, set[0], set[1], set[2]);
+    CHECK(got == ref_memchr_set(orig, len, set, 3), "neon_memchr3 returned %zu", got);
+    return 1;
+}
+
+static int check_find(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static const size_t needle_lens[] = { 0, 1, 2, 3, 4, 5, 8, 15, 16, 17, 31, 32, 33, 64 };
+    for (int k = 0; k < 3; k++) {
+        size_t m = needle_lens[rnd() % (sizeof(needle_lens) / sizeof(needle_lens[0]))];
+        uint8_t* needle = out_buf(&aux_region, m);
+        if (m <= len && rnd() % 4) {
+            memcpy(needle, orig + rnd() % (len - m + 1), m);
+            if (m && rnd() % 2) {
+                needle[rnd() % m] ^= (uint8_t)(1u << (rnd() % 8));   // Near miss
+            }
+        } else {
+            generate(needle, m, cur_mode);
+        }
+        size_t got = neon_find((const char*)buf, len, (const char*)needle, m);
+        size_t want = ref_find(orig, len, needle, m, 0);
+        CHECK(got == want, "neon_find with a %zu-byte needle returned %zu, expected %zu", m, got, want);
+        for (size_t i = 0; i < m; i++) {
+            if (rnd() % 2) {
+                needle[i] = ref_is_upper(needle[i]) ? ref_lower(needle[i]) : ref_upper(needle[i]);
+            }
+        }
+        got = neon_find_nocase((const char*)buf, len, (const char*)needle, m);
+        want = ref_find(orig, len, needle, m, 1);
+        CHECK(got == want, "neon_find_nocase with a %zu-byte needle returned %zu, expected %zu", m, got, want);
+    }
+    return 1;
+}
+
+static int check_delim(uint8_t* buf, const uint8_t* orig, size_t len) {
+    uint8_t delims[16];
+    size_t count = 1 + rnd() % 16;
+    for (size_t k = 0; k < count; k++) {
+        delims[k] = len && rnd() % 2 ? orig[rnd() % len] : (uint8_t)rnd();
+    }
+    neon_delim_set_t set;
+    CHECK(neon_delim_set_init(&set, (const char*)delims, count) == 1, "neon_delim_set_init failed");
+    uint64_t bitmap[MAX_LEN / 64 + 1];
+    uint32_t* offsets = (uint32_t*)out_buf(&dst_region, 4 * len);
+    int valid = -1, valid2 = -1;
+    neon_delim_bitmap((const char*)buf, len, &set, bitmap, &valid);
+    size_t n = neon_delim_offsets((const char*)buf, len, &set, offsets, &valid2);
+    size_t off, j = 0;
+    int want_valid = ref_utf8_validate(orig, len, &off);
+    CHECK(valid == want_valid && valid2 == want_valid, "UTF-8 flags %d/%d, expected %d", valid, valid2, want_valid);
+    for (size_t i = 0; i < len; i++) {
+        int want = ref_memchr_set(orig + i, 1, delims, count) == 0;
+        CHECK((int)(bitmap[i / 64] >> (i % 64) & 1) == want, "neon_delim_bitmap bit %zu is wrong", i);
+        if (want) {
+            CHECK(j < n && offsets[j] == i, "neon_delim_offsets misses offset %zu", i);
+            j++;
+        }
+    }
+    CHECK(j == n, "neon_delim_offsets returned %zu offsets, expected %zu", n, j);
+    return 1;
+}
+
+static int check_key_table(uint8_t* buf, const uint8_t* orig, size_t len) {
+    // Keys cut out of the input; look up the input prefix of each key length
+    static neon_key_table_t table;
+    const char* keys[8];
+    size_t lens[8], n = 1 + rnd() % 8;
+    for (size_t k = 0; k < n; k++) {
+        lens[k] = len ? rnd() % (len < NEON_KEY_TABLE_MAX_LEN ? len + 1 : NEON_KEY_TABLE_MAX_LEN + 1) : 0;
+        keys[k] = (const char*)orig + (len - lens[k] ? rnd() % (len - lens[k] + 1) : 0);
+    }
+    CHECK(neon_key_table_init(&table, keys, lens, n) == 1, "neon_key_table_init failed");
+    for (size_t k = 0; k <= n; k++) {
+        size_t m = k < n ? lens[k] : (len < NEON_KEY_TABLE_MAX_LEN ? len : NEON_KEY_TABLE_MAX_LEN);
+        int want = -1;
+        for (size_t i = 0; i < n && want < 0; i++) {
+            if (lens[i] == m && ref_casecmp((const uint8_t*)keys[i], orig, m) == 0) {
+                want = (int)i;
+            }
+        }
+        int got = neon_key_table_find(&table, (const char*)buf, m);
+        CHECK(got == want, "neon_key_table_find of %zu bytes returned %d, expected %d", m, got, want);
+    }
+    return 1;
+}
+
+// Whitespace, in-place and copying
+
+typedef size_t (*copy_op_fn)(char*, const char*, size_t);
+typedef size_t (*inplace_op_fn)(char*, size_t);
+
+static int check_ws_op(uint8_t* buf, const uint8_t* orig, size_t len, const char* name,
+                       inplace_op_fn inplace, copy_op_fn copy, int op) {
+    static uint8_t want[MAX_LEN];
+    size_t wn = op == 0 ? ref_trim(want, orig, len, 0)
+              : op == 1 ? ref_trim(want, orig, len, 1)
+              : op == 2 ? ref_collapse_whitespace(want, orig, len)
+              : ref_strip_control(want, orig, len);
+    uint8_t* dst = out_buf(&dst_region, len);
+    size_t n = copy((char*)dst, (const char*)buf, len);
+    CHECK(n == wn && memcmp(dst, want, n) == 0, "%s_copy returned %zu, expected %zu", name, n, wn);
+    n = inplace((char*)buf, len);
+    CHECK(n == wn && memcmp(buf, want, n) == 0, "%s returned %zu, expected %zu", name, n, wn);
+    return 1;
+}
+
+static int check_whitespace(uint8_t* buf, const uint8_t* orig, size_t len) {
+    // Family 4 is rich in whitespace and control bytes already; make the
+    // others so too, in runs
+    if (cur_mode != 4) {
+        for (size_t i = 0; i < len; i++) {
+            if (rnd() % 3 == 0) {
+                buf[i] = (uint8_t)" \t\n\v\f\r\x01\x7f"[rnd() % 8];
+            }
+        }
+        orig = memcpy(out_buf(&aux_region, len), buf, len);
+    }
+    static uint8_t saved[MAX_LEN];
+    memcpy(saved, buf, len);
+    if (!check_ws_op(buf, orig, len, "neon_trim", neon_trim, neon_trim_copy, 0)) return 0;
+    memcpy(buf, saved, len);
+    if (!check_ws_op(buf, orig, len, "neon_trim_lower", neon_trim_lower, neon_trim_lower_copy, 1)) return 0;
+    memcpy(buf, saved, len);
+    if (!check_ws_op(buf, orig, len, "neon_collapse_whitespace", neon_collapse_whitespace,
+                     neon_collapse_whitespace_copy, 2)) return 0;
+    memcpy(buf, saved, len);
+    return check_ws_op(buf, orig, len, "neon_strip_control", neon_strip_control, neon_strip_control_copy, 3);
+}
+
+// Numbers: the input mapped to digits, with the family's own bytes left in
+// some places
+
+static int check_parse_u64(uint8_t* buf, const uint8_t* orig, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (cur_mode == 3 ? rnd() % 64 : 1) {
+            buf[i] = (uint8_t)('0' + orig[i] % 10);
+        }
+        if (cur_mode == 1 && i + 20 < len && rnd() % 2) {
+            buf[i] = '0';                           // Long runs of leading zeros
+        }
+    }
+    if (cur_mode == 2 && len >= 20) {
+        memcpy(buf + len - 20, rnd() % 2 ? "18446744073709551615" : "18446744073709551616", 20);
+    }
+    if (cur_mode == 4 && len > 0) {
+        buf[rnd() % len] = orig[0];
+    }
+    static uint8_t copy[MAX_LEN];
+    memcpy(copy, buf, len);
+    uint64_t v = 0x5A5A5A5A5A5A5A5AULL, wv = v;
+    size_t off = 12345, woff;
+    int want = ref_parse_u64(copy, len, &wv, &woff);
+    int got = neon_parse_u64((const char*)buf, len, &v, &off);
+    CHECK(got == want && off == woff, "neon_parse_u64 returned %d at %zu, expected %d at %zu", got, off, want, woff);
+    CHECK(!want || v == wv, "neon_parse_u64 value %llu, expected %llu", (unsigned long long)v, (unsigned long long)wv);
+    return 1;
+}
+
+static int check_hex(uint8_t* buf, const uint8_t* orig, size_t len) {
+    static uint8_t want[2 * MAX_LEN];
+    uint8_t* enc = out_buf(&dst_region, 2 * len);
+    for (int upper = 0; upper < 2; upper++) {
+        size_t n = neon_hex_encode((const char*)buf, len, (char*)enc, upper);
+        ref_hex_encode(orig, len, want, upper);
+        CHECK(n == 2 * len && memcmp(enc, want, n) == 0, "neon_hex_encode(upper = %d) output differs", upper);
+    }
+
+    static const char digits[] = "0123456789abcdefABCDEF";
+    for (size_t i = 0; i < len; i++) {
+        if (cur_mode == 3 ? rnd() % 64 : 1) {
+            buf[i] = (uint8_t)digits[orig[i] % 22];
+        }
+    }
+    if (cur_mode == 2 && len > 0) {
+        buf[rnd() % len] = orig[0];
+    }
+    static uint8_t copy[MAX_LEN], ref_out[MAX_LEN / 2];
+    memcpy(copy, buf, len);
+    uint8_t* dec = out_buf(&dst_region, len / 2);
+    size_t off = 12345, woff;
+    int w = ref_hex_decode(copy, len, ref_out, &woff);
+    int got = neon_hex_decode((const char*)buf, len, (char*)dec, &off);
+    CHECK(got == w && off == woff, "neon_hex_decode returned %d at %zu, expected %d at %zu", got, off, w, woff);
+    CHECK(!got || memcmp(dec, ref_out, len / 2) == 0, "neon_hex_decode output differs");
+    return 1;
+}
+
+typedef struct {
+    const char* name;
+    check_fn fn;
+    int sve;                    // Needs SVE
+} kernel_t;
+
+static const kernel_t kernels[] = {
+    { "neon_to_upper", check_upper, 0 },
+    { "neon_to_lower", check_lower, 0 },
+    { "neon_to_upper_asimd", check_upper_asimd, 0 },
+    { "neon_to_lower_asimd", check_lower_asimd, 0 },
+    { "neon_to_upper_sve", check_upper_sve, 1 },
+    { "neon_to_lower_sve", check_lower_sve, 1 },
+    { "case conversion _copy", check_case_copy, 0 },
+    { "neon_ascii_casecmp / neon_hash_lower", check_casecmp_hash, 0 },
+    { "neon_key_table_find", check_key_table, 0 },
+    { "neon_utf8_to_upper / lower", check_utf8_case, 0 },
+    { "neon_utf8_validate / count_chars", check_validate, 0 },
+    { "neon_utf8_validate_asimd / count_chars_asimd", check_validate_asimd, 0 },
+    { "neon_utf8_validate_sve / count_chars_sve", check_validate_sve, 1 },
+    { "neon_utf8_validate_ex / validate_count / is_ascii", check_validate_variants, 0 },
+    { "neon_utf8_sanitize", check_sanitize, 0 },
+    { "neon_utf8_to_utf16 / utf32", check_transcode, 0 },
+    { "neon_utf16_to_utf8", check_utf16_to_utf8, 0 },
+    { "neon_utf8_stream", check_stream, 0 },
+    { "batch and column validation / case conversion", check_batch, 0 },
+    { "neon_base64", check_base64, 0 },
+    { "neon_memchr / memchr2 / memchr3", check_memchr, 0 },
+    { "neon_find / find_nocase", check_find, 0 },
+    { "neon_delim_bitmap / offsets", check_delim, 0 },
+    { "whitespace trim / collapse / strip", check_whitespace, 0 },
+    { "neon_parse_u64", check_parse_u64, 0 },
+    { "neon_hex_encode / decode", check_hex, 0 },
+};
+
+static int cpu_has_sve(void) {
+#if defined(__linux__) && defined(AT_HWCAP)
+    return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char** argv) {
+    printf("ARM String Operations Differential Tests\n");
+    printf("========================================\n");
+    printf("Lengths 0-%d, alignments 0-%d and end of page, %d input families\n\n",
+           MAX_LEN, MAX_ALIGN - 1, MODES);
+
+    region_init(&src_region);
+    region_init(&dst_region);
+    region_init(&aux_region);
+    signal(SIGSEGV, on_fault);
+    signal(SIGBUS, on_fault);
+
+    int sve = cpu_has_sve();
+    int all_passed = 1;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        int selected = argc < 2;
+        for (int a = 1; a < argc && !selected; a++) {
+            selected = strstr(kernels[k].name, argv[a]) != NULL;
+        }
+        if (!selected) {
+            continue;
+        }
+        if (kernels[k].sve && !sve) {
+            printf("- %s (skipped: no SVE)\n", kernels[k].name);
+            continue;
+        }
+        all_passed &= run(kernels[k].name, kernels[k].fn);
+    }
+
+    printf("\n=== Differential Summary ===\n");
+    printf("%zu cases\n", case_count);
+    if (all_passed) {
+        printf("✓ All kernels match the references!\n");
+        return 0;
+    }
+    printf("✗ Some kernels differ from the references!\n");
+    return 1;
+}
@@ -1,8 +1,11 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "arm_string_ops.h"
 
 #define TEST_ASSERT(condition, message) \
@@ -47,6 +50,208 @@ int test_case_conversion() {
     // Only ASCII parts should change
     TEST_ASSERT(strncmp(utf8_test, "HELLO", 5) == 0, "neon_to_upper ASCII-only conversion");
     
+    // Out-of-place conversion leaves the source untouched
+    const char* src = "Mixed Case Input With Enough Bytes For Several Vectors! 0123456789";
+    char dst[80];
+    memset(dst, 0, sizeof(dst));
+    neon_to_upper_copy(dst, src, strlen(src));
+    TEST_ASSERT(strcmp(dst, "MIXED CASE INPUT WITH ENOUGH BYTES FOR SEVERAL VECTORS! 0123456789") == 0,
+                "neon_to_upper_copy long string");
+    neon_to_lower_copy(dst, src, strlen(src));
+    TEST_ASSERT(strcmp(dst, "mixed case input with enough bytes for several vectors! 0123456789") == 0,
+                "neon_to_lower_copy long string");
+    memset(dst, '#', sizeof(dst));
+    neon_to_upper_copy(dst, "abc", 3);
+    TEST_ASSERT(memcmp(dst, "ABC#", 4) == 0, "neon_to_upper_copy writes only len bytes");
+
+    // Every length up to 200 at every alignment: exercises the short-string
+    // paths, the overlapping final block, and checks the bytes around the buffer
+    char buf[256], expect[256];
+    int case_ok = 1;
+    for (size_t len = 0; len <= 200 && case_ok; len++) {
+        for (size_t align = 0; align < 16 && case_ok; align++) {
+            for (size_t i = 0; i < sizeof(buf); i++) {
+                buf[i] = (char)("aZ9z{`@A"[i % 8] + (i % 3 == 0 ? 0x80 : 0));
+            }
+            memcpy(expect, buf, sizeof(buf));
+            for (size_t i = align + 1; i < align + 1 + len; i++) {
+                if (expect[i] >= 'a' && expect[i] <= 'z') expect[i] -= 32;
+            }
+            neon_to_upper(buf + align + 1, len);
+            case_ok = memcmp(buf, expect, sizeof(buf)) == 0;
+        }
+    }
+    TEST_ASSERT(case_ok, "neon_to_upper all lengths 0-200 and alignments");
+    
+    // Text that is already upper case is never written back: converting a
+    // read-only page of it must not fault
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* ro = mmap(NULL, page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    TEST_ASSERT(ro != MAP_FAILED, "mmap test page");
+    for (size_t i = 0; i < page; i++) {
+        ro[i] = (char)("HEADER: VALUE 0123\r\n\xc3\x89"[i % 22]);
+    }
+    mprotect(ro, page, PROT_READ);
+    neon_to_upper(ro, page);
+    neon_to_upper(ro + 3, 45);
+    neon_to_upper(ro + 1, 2);
+    TEST_ASSERT(ro[0] == 'H', "neon_to_upper skips stores for unchanged blocks");
+    munmap(ro, page);
+    
+    return 1;
+}
+
+// Test case-insensitive compare and hash
+int test_casecmp_hash() {
+    printf("\n=== Testing Case-Insensitive Compare/Hash ===\n");
+    
+    TEST_ASSERT(neon_ascii_casecmp("Content-Type", "content-type", 12) == 0, "neon_ascii_casecmp equal ignoring case");
+    TEST_ASSERT(neon_ascii_casecmp("abc", "abd", 3) < 0, "neon_ascii_casecmp less");
+    TEST_ASSERT(neon_ascii_casecmp("ABD", "abc", 3) > 0, "neon_ascii_casecmp greater");
+    TEST_ASSERT(neon_ascii_casecmp("a[", "A{", 2) < 0, "neon_ascii_casecmp only folds letters");
+    TEST_ASSERT(neon_ascii_casecmp("abc", "xyz", 0) == 0, "neon_ascii_casecmp empty range");
+    
+    // Long strings: the first difference decides, wherever it falls
+    char a[200], b[200];
+    for (size_t i = 0; i < sizeof(a); i++) {
+        a[i] = (char)('a' + i % 26);
+        b[i] = (char)('A' + i % 26);
+    }
+    TEST_ASSERT(neon_ascii_casecmp(a, b, sizeof(a)) == 0, "neon_ascii_casecmp long equal");
+    int order_ok = 1;
+    for (size_t pos = 0; pos < sizeof(a) && order_ok; pos++) {
+        size_t len = pos + 1 + pos % 70;
+        if (len > sizeof(a)) len = sizeof(a);
+        b[pos] = '~';                       // b > a at pos
+        if (pos + 1 < len) b[pos + 1] = 0;  // later bytes must not matter
+        order_ok = neon_ascii_casecmp(a, b, len) < 0 && neon_ascii_casecmp(b, a, len) > 0 &&
+                   neon_ascii_casecmp(a, b, pos) == 0;
+        b[pos] = (char)('A' + pos % 26);
+        if (pos + 1 < sizeof(b)) b[pos + 1] = (char)('A' + (pos + 1) % 26);
+    }
+    TEST_ASSERT(order_ok, "neon_ascii_casecmp finds the first difference at every position");
+    
+    // CRC32C check value of "123456789" is 0xE3069283
+    TEST_ASSERT(neon_hash_lower("123456789", 9, 0) == 0xE3069283u, "neon_hash_lower CRC32C check value");
+    TEST_ASSERT(neon_hash_lower(a, sizeof(a), 0) == neon_hash_lower(b, sizeof(b), 0), "neon_hash_lower ignores case");
+    TEST_ASSERT(neon_hash_lower("Host", 4, 0) != neon_hash_lower("Hosts", 5, 0), "neon_hash_lower length sensitive");
+    uint32_t whole = neon_hash_lower(a, 150, 0);
+    TEST_ASSERT(neon_hash_lower(a + 37, 113, neon_hash_lower(b, 37, 0)) == whole, "neon_hash_lower chaining with seed");
+
+    return 1;
+}
+
+// Test trimming, whitespace collapse and control character stripping
+int test_whitespace() {
+    printf("\n=== Testing Whitespace Operations ===\n");
+
+    char buf[256];
+    char out[256];
+    size_t n;
+
+    strcpy(buf, " \t Hello World \r\n");
+    n = neon_trim(buf, strlen(buf));
+    TEST_ASSERT(n == 11 && memcmp(buf, "Hello World", 11) == 0, "neon_trim short string");
+    strcpy(buf, " \v\f ");
+    TEST_ASSERT(neon_trim(buf, 4) == 0, "neon_trim all whitespace");
+    TEST_ASSERT(neon_trim(buf, 0) == 0, "neon_trim empty string");
+
+    const char* padded = "\n\n        Content-Type: Text/HTML; charset=UTF-8   \t\t   \r\n";
+    n = neon_trim_copy(out, padded, strlen(padded));
+    TEST_ASSERT(n == 38 && memcmp(out, "Content-Type: Text/HTML; charset=UTF-8", 38) == 0, "neon_trim_copy long string");
+    n = neon_trim_lower_copy(out, padded, strlen(padded));
+    TEST_ASSERT(n == 38 && memcmp(out, "content-type: text/html; charset=utf-8", 38) == 0, "neon_trim_lower_copy");
+    strcpy(buf, padded);
+    n = neon_trim_lower(buf, strlen(buf));
+    TEST_ASSERT(n == 38 && memcmp(buf, "content-type: text/html; charset=utf-8", 38) == 0, "neon_trim_lower in-place");
+
+    strcpy(buf, "  a \t\n b  c\r\n");
+    n = neon_collapse_whitespace(buf, strlen(buf));
+    TEST_ASSERT(n == 7 && memcmp(buf, " a b c ", 7) == 0, "neon_collapse_whitespace short string");
+    const char* spaced = "The   quick\t\tbrown   fox\n\n\njumps  over     the lazy\r\ndog  ";
+    n = neon_collapse_whitespace_copy(out, spaced, strlen(spaced));
+    TEST_ASSERT(n == 44 && memcmp(out, "The quick brown fox jumps over the lazy dog ", 44) == 0,
+                "neon_collapse_whitespace_copy long string");
+
+    const char* noisy = "ab\x01" "c\x1b[0m\tline\x7f" "one\n\x00two\x0e\x1f" "three four five six";
+    size_t noisy_len = 43;
+    n = neon_strip_control_copy(out, noisy, noisy_len);
+    TEST_ASSERT(n == 37 && memcmp(out, "abc[0m\tlineone\ntwothree four five six", 37) == 0,
+                "neon_strip_control_copy keeps whitespace");
+    memcpy(buf, noisy, noisy_len);
+    TEST_ASSERT(neon_strip_control(buf, noisy_len) == 37 && memcmp(buf, out, 37) == 0, "neon_strip_control in-place");
+
+    // Runs crossing every 16-byte boundary: each result is one word per run
+    int runs_ok = 1;
+    for (size_t pos = 0; pos + 20 <= sizeof(buf) && runs_ok; pos++) {
+        memset(buf, 'x', sizeof(buf));
+        memset(buf + pos, ' ', 3 + pos % 17);
+        n = neon_collapse_whitespace_copy(out, buf, sizeof(buf));
+        runs_ok = n == sizeof(buf) - 2 - pos % 17 && out[pos] == ' ' && out[pos + 1] == 'x' &&
+                  (pos == 0 || out[pos - 1] == 'x');
+    }
+    TEST_ASSERT(runs_ok, "neon_collapse_whitespace runs at every position");
+
+    return 1;
+}
+
+// Test Unicode-aware case conversion
+int test_utf8_case() {
+    printf("\n=== Testing Unicode Case Conversion ===\n");
+    
+    char out[512];
+    size_t n;
+    
+    // Latin-1, Greek and Cyrillic (vector path)
+    const char* mixed = "Caf\xc3\xa9 \xc3\xb1" "and\xc3\xba \xce\xb1\xce\xb2\xce\xb3 "
+                        "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82";   // Café ñandú αβγ привет
+    n = neon_utf8_to_upper(out, mixed, strlen(mixed));
+    TEST_ASSERT(n == strlen(mixed) &&
+                memcmp(out, "CAF\xc3\x89 \xc3\x91" "AND\xc3\x9a \xce\x91\xce\x92\xce\x93 "
+                            "\xd0\x9f\xd0\xa0\xd0\x98\xd0\x92\xd0\x95\xd0\xa2", n) == 0,
+                "neon_utf8_to_upper Latin-1/Greek/Cyrillic");
+    char back[512];
+    size_t m = neon_utf8_to_lower(back, out, n);
+    const char* lowered = "caf\xc3\xa9 \xc3\xb1" "and\xc3\xba \xce\xb1\xce\xb2\xce\xb3 "
+                          "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82";
+    TEST_ASSERT(m == strlen(lowered) && memcmp(back, lowered, m) == 0, "neon_utf8_to_lower round trip");
+    
+    // Lead byte changes (\xc3\xbf -> \xc5\xb8, \xd1\x8f -> \xd0\xaf) across a long input
+    char buf[300];
+    for (size_t i = 0; i < 150; i++) {
+        memcpy(buf + 2 * i, (i % 3 == 0) ? "\xc3\xbf" : (i % 3 == 1) ? "\xd1\x8f" : "ab", 2);
+    }
+    n = neon_utf8_to_upper(out, buf, sizeof(buf));
+    int lead_ok = n == sizeof(buf);
+    for (size_t i = 0; i < 150 && lead_ok; i++) {
+        lead_ok = memcmp(out + 2 * i, (i % 3 == 0) ? "\xc5\xb8" : (i % 3 == 1) ? "\xd0\xaf" : "AB", 2) == 0;
+    }
+    TEST_ASSERT(lead_ok, "neon_utf8_to_upper mappings that change the lead byte");
+    
+    // Scalar path: 3- and 4-byte mappings, and mappings that shrink
+    n = neon_utf8_to_upper(out, "\xe1\xb8\x81\xef\xbd\x81\xf0\x90\x90\xa8", 10);   // ḁ ａ 𐐨
+    TEST_ASSERT(n == 10 && memcmp(out, "\xe1\xb8\x80\xef\xbc\xa1\xf0\x90\x90\x80", 10) == 0,
+                "neon_utf8_to_upper 3- and 4-byte mappings");
+    n = neon_utf8_to_upper(out, "\xc4\xb1x", 3);          // dotless i -> I
+    TEST_ASSERT(n == 2 && memcmp(out, "IX", 2) == 0, "neon_utf8_to_upper shrinking mapping");
+    n = neon_utf8_to_lower(out, "\xe2\x84\xaa", 3);      // Kelvin sign -> k
+    TEST_ASSERT(n == 1 && out[0] == 'k', "neon_utf8_to_lower Kelvin sign");
+    n = neon_utf8_to_upper(out, "stra\xc3\x9f" "e", 7);   // ß has no single-character upper case
+    TEST_ASSERT(n == 7 && memcmp(out, "STRA\xc3\x9f" "E", 7) == 0, "neon_utf8_to_upper keeps sharp s");
+    
+    // Invalid bytes are copied through unchanged
+    n = neon_utf8_to_upper(out, "a\xff\xc3(b\xe0\x80\x80", 8);
+    TEST_ASSERT(n == 8 && memcmp(out, "A\xff\xc3(B\xe0\x80\x80", 8) == 0, "neon_utf8_to_upper invalid input");
+    
+    // In place
+    char inplace[] = "\xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0 \xc4\xb0stanbul";  // Москва İstanbul
+    n = neon_utf8_to_lower(inplace, inplace, strlen(inplace));
+    TEST_ASSERT(n == strlen(inplace) - 1 &&
+                memcmp(inplace, "\xd0\xbc\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0 istanbul", n) == 0,
+                "neon_utf8_to_lower in place");
+    
+    TEST_ASSERT(neon_utf8_to_upper(out, "", 0) == 0, "neon_utf8_to_upper empty string");
+    
     return 1;
 }
 
@@ -74,6 +279,801 @@ int test_utf8_ops() {
     TEST_ASSERT(neon_utf8_validate("", 0) == 1, "UTF-8 validation empty string");
     TEST_ASSERT(neon_utf8_count_chars("", 0) == 0, "UTF-8 char count empty string");
     
+    // ASCII detection
+    TEST_ASSERT(neon_is_ascii("", 0) == 1, "neon_is_ascii empty string");
+    TEST_ASSERT(neon_is_ascii(ascii_text, strlen(ascii_text)) == 1, "neon_is_ascii ASCII text");
+    TEST_ASSERT(neon_is_ascii("caf\xc3\xa9", 5) == 0, "neon_is_ascii rejects multibyte");
+    char ascii_buf[150];
+    memset(ascii_buf, 'x', sizeof(ascii_buf));
+    int ascii_ok = 1;
+    for (size_t len = 1; len <= sizeof(ascii_buf) && ascii_ok; len++) {
+        ascii_ok = neon_is_ascii(ascii_buf, len) == 1;
+        for (size_t pos = 0; pos < len && ascii_ok; pos++) {
+            ascii_buf[pos] = (char)0x80;
+            ascii_ok = neon_is_ascii(ascii_buf, len) == 0;
+            ascii_buf[pos] = 'x';
+        }
+    }
+    TEST_ASSERT(ascii_ok, "neon_is_ascii finds a high byte at every position");
+    
+    return 1;
+}
+
+// Test UTF-8 validation of multibyte and malformed input
+int test_utf8_validation() {
+    printf("\n=== Testing UTF-8 Validation ===\n");
+    
+    // Valid multibyte sequences, including the range boundaries
+    const char* multibyte = "caf\xc3\xa9 \xe4\xb8\x96\xe7\x95\x8c \xf0\x9f\x98\x80";
+    TEST_ASSERT(neon_utf8_validate(multibyte, strlen(multibyte)) == 1, "UTF-8 validation multibyte");
+    const char* bounds = "\xc2\x80\xdf\xbf\xe0\xa0\x80\xed\x9f\xbf\xee\x80\x80\xef\xbf\xbf"
+                         "\xf0\x90\x80\x80\xf4\x8f\xbf\xbf";
+    TEST_ASSERT(neon_utf8_validate(bounds, strlen(bounds)) == 1, "UTF-8 validation range boundaries");
+    
+    // Malformed sequences
+    TEST_ASSERT(neon_utf8_validate("\x80", 1) == 0, "UTF-8 rejects stray continuation");
+    TEST_ASSERT(neon_utf8_validate("\xc0\xaf", 2) == 0, "UTF-8 rejects 2-byte overlong");
+    TEST_ASSERT(neon_utf8_validate("\xe0\x80\xaf", 3) == 0, "UTF-8 rejects 3-byte overlong");
+    TEST_ASSERT(neon_utf8_validate("\xf0\x80\x80\xaf", 4) == 0, "UTF-8 rejects 4-byte overlong");
+    TEST_ASSERT(neon_utf8_validate("\xed\xa0\x80", 3) == 0, "UTF-8 rejects surrogate");
+    TEST_ASSERT(neon_utf8_validate("\xf4\x90\x80\x80", 4) == 0, "UTF-8 rejects > U+10FFFF");
+    TEST_ASSERT(neon_utf8_validate("\xf5\x80\x80\x80", 4) == 0, "UTF-8 rejects F5 lead byte");
+    TEST_ASSERT(neon_utf8_validate("\xff", 1) == 0, "UTF-8 rejects FF byte");
+    TEST_ASSERT(neon_utf8_validate("abc\xe2\x82", 5) == 0, "UTF-8 rejects truncated sequence");
+    TEST_ASSERT(neon_utf8_validate("\xe2\x82\x41", 3) == 0, "UTF-8 rejects short sequence");
+    
+    // Errors on both sides of the 64-byte block boundary
+    char block[200];
+    int ok = 1;
+    for (size_t pos = 0; pos + 4 <= sizeof(block); pos++) {
+        memset(block, 'a', sizeof(block));
+        memcpy(block + pos, "\xf0\x9f\x98\x80", 4);
+        ok &= neon_utf8_validate(block, sizeof(block)) == 1;
+        block[pos + 3] = 'a';
+        ok &= neon_utf8_validate(block, sizeof(block)) == 0;
+        ok &= neon_utf8_validate(block, pos + 3) == 0;
+    }
+    TEST_ASSERT(ok, "UTF-8 validation at every block offset");
+    
+    // Error position reporting
+    size_t offset = 0;
+    TEST_ASSERT(neon_utf8_validate_ex(multibyte, strlen(multibyte), &offset) == 1 &&
+                offset == strlen(multibyte), "UTF-8 validate_ex valid input");
+    TEST_ASSERT(neon_utf8_validate_ex("ab\xc3\xa9\xff", 5, &offset) == 0 && offset == 4,
+                "UTF-8 validate_ex invalid byte offset");
+    TEST_ASSERT(neon_utf8_validate_ex("abc\xe2\x82", 5, &offset) == 0 && offset == 3,
+                "UTF-8 validate_ex truncated sequence offset");
+    ok = 1;
+    for (size_t pos = 0; pos + 4 <= sizeof(block); pos++) {
+        memset(block, 'a', sizeof(block));
+        memcpy(block + pos, "\xf0\x9f\x98\x80", 4);
+        block[pos + 3] = 'a';
+        ok &= neon_utf8_validate_ex(block, sizeof(block), &offset) == 0 && offset == pos;
+        ok &= neon_utf8_validate_ex(block, pos + 3, &offset) == 0 && offset == pos;
+        memcpy(block + pos, "\xf0\x9f\x98\x80\x80", pos + 5 <= sizeof(block) ? 5 : 4);
+        ok &= neon_utf8_validate_ex(block, sizeof(block), &offset) == (pos + 5 > sizeof(block));
+        ok &= offset == (pos + 5 <= sizeof(block) ? pos + 4 : sizeof(block));
+    }
+    TEST_ASSERT(ok, "UTF-8 validate_ex offset at every block position");
+    
+    return 1;
+}
+
+// Test lossy repair of invalid UTF-8
+int test_utf8_sanitize() {
+    printf("\n=== Testing UTF-8 Sanitize ===\n");
+    
+    char out[600];
+    const char* valid = "caf\xc3\xa9 \xe4\xb8\x96\xe7\x95\x8c \xf0\x9f\x98\x80";
+    size_t n = neon_utf8_sanitize(out, valid, strlen(valid));
+    TEST_ASSERT(n == strlen(valid) && memcmp(out, valid, n) == 0, "UTF-8 sanitize copies valid input");
+    TEST_ASSERT(neon_utf8_sanitize(out, NULL, 0) == 0, "UTF-8 sanitize empty input");
+    
+    // One U+FFFD per maximal subpart: a truncated sequence is one error, a
+    // byte that can never start or continue one is an error of its own
+    n = neon_utf8_sanitize(out, "a\xe4\xb8z\xc0\xaf\xed\xa0\x80\xf0\x9f\x98", 12);
+    const char* want = "a\xef\xbf\xbdz\xef\xbf\xbd\xef\xbf\xbd"
+                       "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd";
+    TEST_ASSERT(n == strlen(want) && memcmp(out, want, n) == 0, "UTF-8 sanitize maximal subparts");
+    
+    // An error at every position of a multi-block input, including sequences
+    // cut by a block boundary and trailing garbage
+    char text[200];
+    int ok = 1;
+    for (size_t pos = 0; pos + 4 <= sizeof(text); pos += 2) {
+        for (size_t i = 0; i < sizeof(text); i++) {
+            text[i] = "\xc3\xa9"[i % 2];
+        }
+        memcpy(text + pos, "\xe2\x82zz", 4);
+        n = neon_utf8_sanitize(out, text, sizeof(text));
+        ok &= n == sizeof(text) + 1;
+        ok &= out[pos] == (char)0xEF && out[pos + 1] == (char)0xBF && out[pos + 2] == (char)0xBD;
+        ok &= out[pos + 3] == 'z';
+        ok &= neon_utf8_validate(out, n) == 1;
+    }
+    memset(text, 0xFF, sizeof(text));
+    n = neon_utf8_sanitize(out, text, sizeof(text));
+    ok &= n == 3 * sizeof(text) && neon_utf8_validate(out, n) == 1;
+    TEST_ASSERT(ok, "UTF-8 sanitize errors at every block position");
+    
+    return 1;
+}
+
+// Test streaming validation with sequences split across chunks
+int test_utf8_stream() {
+    printf("\n=== Testing UTF-8 Streaming Validation ===\n");
+    
+    char text[300];
+    size_t len = 0;
+    while (len + 10 <= sizeof(text)) {
+        memcpy(text + len, "a\xc3\xa9\xe4\xb8\x96\xf0\x9f\x98\x80", 10);
+        len += 10;
+    }
+    
+    neon_utf8_stream_t st;
+    int ok = 1;
+    for (size_t chunk = 1; chunk <= 70; chunk++) {
+        neon_utf8_stream_init(&st);
+        for (size_t pos = 0; pos < len; pos += chunk) {
+            size_t n = len - pos < chunk ? len - pos : chunk;
+            ok &= neon_utf8_stream_update(&st, text + pos, n) == 1;
+        }
+        ok &= neon_utf8_stream_finish(&st) == 1;
+    }
+    TEST_ASSERT(ok, "UTF-8 stream valid text in every chunk size");
+    
+    ok = 1;
+    for (size_t chunk = 1; chunk <= 70; chunk++) {
+        neon_utf8_stream_init(&st);
+        for (size_t pos = 0; pos < len - 1; pos += chunk) {
+            size_t n = len - 1 - pos < chunk ? len - 1 - pos : chunk;
+            neon_utf8_stream_update(&st, text + pos, n);
+        }
+        ok &= neon_utf8_stream_finish(&st) == 0;
+    }
+    TEST_ASSERT(ok, "UTF-8 stream rejects truncated end");
+    
+    neon_utf8_stream_init(&st);
+    neon_utf8_stream_update(&st, "ab\xed", 3);
+    neon_utf8_stream_update(&st, "\xa0\x80" "cd", 4);
+    TEST_ASSERT(neon_utf8_stream_finish(&st) == 0, "UTF-8 stream rejects split surrogate");
+    
+    neon_utf8_stream_init(&st);
+    TEST_ASSERT(neon_utf8_stream_finish(&st) == 1, "UTF-8 stream empty input");
+    
+    return 1;
+}
+
+// Test the batch and column entry points
+int test_batch() {
+    printf("\n=== Testing Batch Operations ===\n");
+    
+    // Short fields around the 61-byte packing limit and the 64-byte block,
+    // with invalid ones and a character split across two fields
+    char fields[12][80];
+    size_t lens[12];
+    const char* strs[12];
+    for (int i = 0; i < 12; i++) {
+        lens[i] = (size_t)(i * 7) % 70;
+        memset(fields[i], 'A' + i, lens[i]);
+        strs[i] = fields[i];
+    }
+    lens[3] = 0;
+    memcpy(fields[4], "caf\xc3\xa9", 5);                 // valid multibyte
+    memcpy(fields[5] + 10, "\xff", 1);                    // invalid byte
+    memcpy(fields[6] + lens[6] - 1, "\xc3", 1);           // truncated at the end
+    memcpy(fields[7], "\xa9", 1);                         // ... continues here
+    memcpy(fields[9] + 30, "\xed\xa0\x80", 3);            // surrogate, 63-byte field
+    uint8_t valid[2] = { 0, 0 };
+    neon_utf8_validate_batch(strs, lens, 12, valid);
+    TEST_ASSERT(valid[0] == 0x1F && valid[1] == 0x0D, "validate_batch per-string results");
+    
+    // The same strings as an Arrow column
+    char blob[1024];
+    int32_t offsets[13];
+    offsets[0] = 0;
+    for (int i = 0; i < 12; i++) {
+        memcpy(blob + offsets[i], fields[i], lens[i]);
+        offsets[i + 1] = offsets[i] + (int32_t)lens[i];
+    }
+    memset(valid, 0, sizeof(valid));
+    neon_utf8_validate_column(blob, offsets, 12, valid);
+    TEST_ASSERT(valid[0] == 0x1F && valid[1] == 0x0D, "validate_column per-string results");
+    memcpy(blob + offsets[5] + 10, "a", 1);
+    memcpy(blob + offsets[9] + 30, "abc", 3);
+    memcpy(blob + offsets[7], "a", 1);
+    memset(valid, 0, sizeof(valid));
+    neon_utf8_validate_column(blob, offsets, 12, valid);
+    TEST_ASSERT(valid[0] == 0xBF && valid[1] == 0x0F, "validate_column field ending mid-sequence");
+    blob[offsets[7] - 1] = 'a';
+    memset(valid, 0, sizeof(valid));
+    neon_utf8_validate_column(blob, offsets, 12, valid);
+    TEST_ASSERT(valid[0] == 0xFF && valid[1] == 0x0F, "validate_column valid column");
+    valid[0] = 0xAA;
+    neon_utf8_validate_column(blob, offsets, 0, valid);
+    TEST_ASSERT(valid[0] == 0xAA, "validate_column empty column");
+    
+    // Case conversion of every field, separately and as a column
+    char* mut[12];
+    for (int i = 0; i < 12; i++) {
+        mut[i] = fields[i];
+    }
+    neon_to_lower_batch(mut, lens, 12);
+    int ok = 1;
+    for (int i = 0; i < 12; i++) {
+        ok &= lens[i] < 30 || (fields[i][lens[i] - 2] == 'a' + i && fields[i][20] == 'a' + i);
+    }
+    TEST_ASSERT(ok, "to_lower_batch converts every string");
+    neon_to_upper_column(blob, offsets, 12);
+    TEST_ASSERT(blob[offsets[11]] == 'L' && blob[offsets[1]] == 'B' && memcmp(blob + offsets[4], "CAF", 3) == 0,
+                "to_upper_column converts the column");
+    
+    return 1;
+}
+
+// Test byte and substring search
+int test_search() {
+    printf("\n=== Testing Search ===\n");
+    
+    const char* line = "2024-05-01 12:00:00 INFO request id=42 path=/api/v1";
+    size_t len = strlen(line);
+    TEST_ASSERT(neon_memchr(line, len, ' ') == 10, "memchr first space");
+    TEST_ASSERT(neon_memchr(line, len, '#') == len, "memchr not found returns len");
+    TEST_ASSERT(neon_memchr(line, 0, '2') == 0, "memchr empty buffer");
+    TEST_ASSERT(neon_memchr2(line, len, '=', ':') == 13, "memchr2 first of two bytes");
+    TEST_ASSERT(neon_memchr3(line, len, '/', '=', 'I') == 20, "memchr3 first of three bytes");
+    TEST_ASSERT(neon_memchr("ab\xff", 3, -1) == 2, "memchr uses the low byte of c");
+    
+    TEST_ASSERT(neon_find(line, len, "id=", 3) == 33, "find substring");
+    TEST_ASSERT(neon_find(line, len, "/api/v1", 7) == len - 7, "find at the end");
+    TEST_ASSERT(neon_find(line, len, "/api/v2", 7) == len, "find not found returns len");
+    TEST_ASSERT(neon_find(line, len, "", 0) == 0, "find empty needle");
+    TEST_ASSERT(neon_find("abc", 3, "abcd", 4) == 3, "find needle longer than haystack");
+    
+    // Match at every position, with near misses before it that pass the
+    // first/last byte filter
+    char buf[300];
+    int ok = 1;
+    for (size_t pos = 0; pos + 12 <= sizeof(buf); pos++) {
+        memset(buf, '.', sizeof(buf));
+        for (size_t i = 0; i + 12 <= pos; i += 12) {
+            memcpy(buf + i, "<near-miss!>", 12);
+        }
+        memcpy(buf + pos, "<needle-abc>", 12);
+        ok &= neon_memchr(buf + pos, sizeof(buf) - pos, '<') == 0;
+        ok &= neon_memchr2(buf, sizeof(buf), 'n', 'e') == (pos < 12 ? pos + 1 : 1);
+        ok &= neon_memchr3(buf, sizeof(buf), 'x', 'c', 'b') == pos + 9;
+        ok &= neon_find(buf, sizeof(buf), "<needle-abc>", 12) == pos;
+        ok &= neon_find(buf, pos + 11, "<needle-abc>", 12) == pos + 11;
+        ok &= neon_find(buf, sizeof(buf), "e-a", 3) == pos + 6;
+        ok &= neon_find_nocase(buf, sizeof(buf), "<NEEDLE-Abc>", 12) == pos;
+        ok &= neon_find_nocase(buf, pos + 11, "<needle-ABC>", 12) == pos + 11;
+        ok &= neon_find_nocase(buf, sizeof(buf), "E-A", 3) == pos + 6;
+    }
+    TEST_ASSERT(ok, "search at every block offset");
+    
+    // Case-insensitive search only folds ASCII letters
+    const char* headers = "Accept: */*\r\nCONTENT-TYPE: text/html\r\nX-Trace: [ab]\r\n";
+    size_t hlen = strlen(headers);
+    TEST_ASSERT(neon_find_nocase(headers, hlen, "content-type:", 13) == 13, "neon_find_nocase header name");
+    TEST_ASSERT(neon_find_nocase(headers, hlen, "x-TRACE", 7) == 38, "neon_find_nocase mixed case needle");
+    TEST_ASSERT(neon_find_nocase(headers, hlen, "X", 1) == 29, "neon_find_nocase single byte");
+    TEST_ASSERT(neon_find_nocase(headers, hlen, "{AB}", 4) == hlen, "neon_find_nocase does not fold [ and {");
+    TEST_ASSERT(neon_find_nocase(headers, hlen, "", 0) == 0, "neon_find_nocase empty needle");
+    
+    // Key table: HTTP header names looked up ignoring case
+    const char* names[] = { "host", "Content-Type", "content-length", "Accept",
+                            "accept-encoding", "x-request-id", "" };
+    size_t lens[7];
+    for (int i = 0; i < 7; i++) {
+        lens[i] = strlen(names[i]);
+    }
+    neon_key_table_t table;
+    TEST_ASSERT(neon_key_table_init(&table, names, lens, 7) == 1, "neon_key_table_init");
+    TEST_ASSERT(neon_key_table_find(&table, "HOST", 4) == 0, "neon_key_table_find short key");
+    TEST_ASSERT(neon_key_table_find(&table, "content-type", 12) == 1, "neon_key_table_find folded key");
+    TEST_ASSERT(neon_key_table_find(&table, "Accept-Encoding", 15) == 4, "neon_key_table_find same prefix");
+    TEST_ASSERT(neon_key_table_find(&table, "Accep", 5) == -1, "neon_key_table_find prefix is no match");
+    TEST_ASSERT(neon_key_table_find(&table, "X-Request-Ie", 12) == -1, "neon_key_table_find last byte differs");
+    TEST_ASSERT(neon_key_table_find(&table, NULL, 0) == 6, "neon_key_table_find empty key");
+    char long_key[65];
+    memset(long_key, 'k', sizeof(long_key));
+    lens[0] = 64;
+    names[0] = long_key;
+    TEST_ASSERT(neon_key_table_init(&table, names, lens, 1) == 1 &&
+                neon_key_table_find(&table, long_key, 64) == 0 &&
+                neon_key_table_find(&table, long_key, 65) == -1, "neon_key_table 64-byte keys");
+    lens[0] = 65;
+    TEST_ASSERT(neon_key_table_init(&table, names, lens, 1) == 0, "neon_key_table_init rejects long keys");
+    
+    return 1;
+}
+
+// Test base64 encoding and decoding
+int test_base64() {
+    printf("\n=== Testing Base64 ===\n");
+    
+    // RFC 4648 test vectors
+    const char* plain[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+    const char* coded[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+    char enc[64], dec[64];
+    size_t n = 0;
+    int ok = 1;
+    for (int i = 0; i < 7; i++) {
+        size_t len = strlen(plain[i]);
+        ok &= neon_base64_encode(plain[i], len, enc) == strlen(coded[i]) &&
+              memcmp(enc, coded[i], strlen(coded[i])) == 0;
+        ok &= neon_base64_decode(coded[i], strlen(coded[i]), dec, &n) == 1 && n == len &&
+              memcmp(dec, plain[i], len) == 0;
+    }
+    TEST_ASSERT(ok, "base64 RFC 4648 vectors");
+    
+    TEST_ASSERT(neon_base64_decode("Zm9v YmFy", 9, dec, &n) == 0 && n == 4, "base64 rejects whitespace");
+    TEST_ASSERT(neon_base64_decode("Zm9vYmF", 7, dec, &n) == 0 && n == 4, "base64 rejects incomplete group");
+    TEST_ASSERT(neon_base64_decode("Zg==Zg==", 8, dec, &n) == 0 && n == 2, "base64 rejects inner padding");
+    TEST_ASSERT(neon_base64_decode("Z===", 4, dec, &n) == 0 && n == 1, "base64 rejects three '='");
+    
+    // Round trips through the vector loops and every tail length, with the
+    // fused UTF-8 check on text and on text cut inside a character
+    char text[300], b64[400], out[300];
+    for (size_t i = 0; i < sizeof(text); i++) {
+        text[i] = "ab \xc3\xa9 \xe4\xb8\x96 \xf0\x9f\x98\x80"[i % 14];
+    }
+    ok = 1;
+    for (size_t len = 0; len <= sizeof(text); len++) {
+        size_t chars = neon_base64_encode(text, len, b64);
+        int utf8 = -1;
+        ok &= chars == (len + 2) / 3 * 4;
+        ok &= neon_base64_decode_utf8(b64, chars, out, &n, &utf8) == 1 && n == len &&
+              memcmp(out, text, len) == 0;
+        ok &= utf8 == neon_utf8_validate(text, len);
+    }
+    TEST_ASSERT(ok, "base64 round trips with UTF-8 check");
+    
+    size_t chars = neon_base64_encode(text, 200, b64);
+    b64[100] = '.';
+    int utf8 = -1;
+    TEST_ASSERT(neon_base64_decode_utf8(b64, chars, out, &n, &utf8) == 0 && n == 100 && utf8 == 0,
+                "base64 reports the offset of a bad character");
+    
+    return 1;
+}
+
+// Test decimal parsing and hex encoding/decoding
+int test_numbers() {
+    printf("\n=== Testing Number Parsing ===\n");
+
+    uint64_t v = 0;
+    size_t off = 0;
+    TEST_ASSERT(neon_parse_u64("12345", 5, &v, &off) == 1 && v == 12345 && off == 5, "neon_parse_u64 short number");
+    TEST_ASSERT(neon_parse_u64("0000000000000000000000042", 25, &v, &off) == 1 && v == 42, "neon_parse_u64 leading zeros");
+    TEST_ASSERT(neon_parse_u64("18446744073709551615", 20, &v, &off) == 1 && v == UINT64_MAX, "neon_parse_u64 UINT64_MAX");
+    TEST_ASSERT(neon_parse_u64("18446744073709551616", 20, &v, &off) == 0 && off == 19, "neon_parse_u64 overflow offset");
+    TEST_ASSERT(neon_parse_u64("123456789012345678901", 21, &v, &off) == 0 && off == 20, "neon_parse_u64 too many digits");
+    TEST_ASSERT(neon_parse_u64("12a4", 4, &v, &off) == 0 && off == 2, "neon_parse_u64 non-digit offset");
+    TEST_ASSERT(neon_parse_u64("", 0, &v, &off) == 0 && off == 0, "neon_parse_u64 rejects empty input");
+    TEST_ASSERT(neon_parse_u64(" 1", 2, &v, NULL) == 0, "neon_parse_u64 rejects whitespace");
+
+    // Every length and position of a bad byte
+    char digits[32];
+    int ok = 1;
+    for (size_t len = 1; len <= 19; len++) {
+        uint64_t want = 0;
+        for (size_t i = 0; i < len; i++) {
+            digits[i] = (char)('1' + (i * 7) % 9);
+            want = want * 10 + (uint64_t)(digits[i] - '0');
+        }
+        ok &= neon_parse_u64(digits, len, &v, &off) == 1 && v == want && off == len;
+        for (size_t i = 0; i < len; i++) {
+            char c = digits[i];
+            digits[i] = i % 2 ? '/' : ':';
+            ok &= neon_parse_u64(digits, len, &v, &off) == 0 && off == i;
+            digits[i] = c;
+        }
+    }
+    TEST_ASSERT(ok, "neon_parse_u64 all lengths and error positions");
+
+    // Hex round trip through the vector loops and the tails
+    char bytes[100], hex[200], back[100];
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (char)(i * 37 + 11);
+    }
+    ok = 1;
+    for (size_t len = 0; len <= sizeof(bytes); len++) {
+        ok &= neon_hex_encode(bytes, len, hex, (int)(len % 2)) == 2 * len;
+        ok &= neon_hex_decode(hex, 2 * len, back, &off) == 1 && off == 2 * len && memcmp(back, bytes, len) == 0;
+    }
+    TEST_ASSERT(ok, "hex round trips in both cases");
+    neon_hex_encode("\x01\xab\xff", 3, hex, 0);
+    TEST_ASSERT(memcmp(hex, "01abff", 6) == 0, "neon_hex_encode lowercase digits");
+    neon_hex_encode("\x01\xab\xff", 3, hex, 1);
+    TEST_ASSERT(memcmp(hex, "01ABFF", 6) == 0, "neon_hex_encode uppercase digits");
+
+    neon_hex_encode(bytes, 40, hex, 0);
+    hex[50] = 'g';
+    TEST_ASSERT(neon_hex_decode(hex, 80, back, &off) == 0 && off == 50 && memcmp(back, bytes, 25) == 0,
+                "neon_hex_decode reports a bad digit");
+    TEST_ASSERT(neon_hex_decode("abc", 3, back, &off) == 0 && off == 2, "neon_hex_decode rejects odd length");
+
+    return 1;
+}
+
+// Test the delimiter scanner
+int test_delim_scan() {
+    printf("\n=== Testing Delimiter Scanner ===\n");
+    
+    neon_delim_set_t csv;
+    TEST_ASSERT(neon_delim_set_init(&csv, ",\n\t\"", 4) == 1, "delim set init");
+    const char* rec = "id,name\n7,\"caf\xc3\xa9\"\t\n";
+    size_t len = strlen(rec);
+    uint32_t offsets[64];
+    const uint32_t expected[] = { 2, 7, 9, 10, 16, 17, 18 };
+    int valid = -1;
+    size_t n = neon_delim_offsets(rec, len, &csv, offsets, &valid);
+    TEST_ASSERT(n == 7 && memcmp(offsets, expected, sizeof(expected)) == 0, "delim offsets CSV record");
+    TEST_ASSERT(valid == 1, "delim offsets validates UTF-8");
+    uint64_t bitmap[8];
+    neon_delim_bitmap(rec, len, &csv, bitmap, NULL);
+    TEST_ASSERT(bitmap[0] == 0x70684, "delim bitmap CSV record");
+    neon_delim_bitmap("a,\xc3", 3, &csv, bitmap, &valid);
+    TEST_ASSERT(bitmap[0] == 0x2 && valid == 0, "delim bitmap reports invalid UTF-8");
+    
+    neon_delim_set_t none;
+    neon_delim_set_init(&none, NULL, 0);
+    TEST_ASSERT(neon_delim_offsets(rec, len, &none, offsets, NULL) == 0, "delim empty set");
+    TEST_ASSERT(neon_delim_set_init(&none, "0123456789abcdefg", 17) == 0, "delim set rejects 17 bytes");
+    
+    // 16 delimiters with 16 different high nibbles need both table pairs;
+    // the NUL delimiter also checks that the zero padded tail is masked
+    char wide_delims[16];
+    for (int i = 0; i < 16; i++) {
+        wide_delims[i] = (char)(i * 0x11);
+    }
+    neon_delim_set_t wide;
+    TEST_ASSERT(neon_delim_set_init(&wide, wide_delims, 16) == 1, "delim set init 16 bytes");
+    char buf[200];
+    int ok = 1;
+    for (size_t pos = 0; pos < sizeof(buf); pos++) {
+        memset(buf, 'a', sizeof(buf));
+        buf[pos] = (char)((pos % 16) * 0x11);
+        for (size_t len2 = pos + 1; len2 <= sizeof(buf); len2 += 37) {
+            memset(bitmap, 0xAA, sizeof(bitmap));
+            neon_delim_bitmap(buf, len2, &wide, bitmap, &valid);
+            for (size_t w = 0; w < (len2 + 63) / 64; w++) {
+                ok &= bitmap[w] == (w == pos / 64 ? 1ULL << (pos % 64) : 0);
+            }
+            ok &= valid == ((unsigned char)buf[pos] < 0x80);
+            ok &= neon_delim_offsets(buf, len2, &wide, offsets, NULL) == 1 && offsets[0] == pos;
+        }
+    }
+    TEST_ASSERT(ok, "delim scan at every block offset");
+    
+    return 1;
+}
+
+// Test load-time kernel selection
+int test_dispatch() {
+    printf("\n=== Testing Runtime Dispatch (%s) ===\n", neon_impl_name());
+    
+    const char* impl = neon_impl_name();
+    TEST_ASSERT(strcmp(impl, "neon") == 0 || strcmp(impl, "sve") == 0, "dispatch selects a known implementation");
+    
+    // The dispatched kernels must agree with the NEON baseline at every
+    // length around the vector sizes, with and without errors
+    const char* pattern = "Hello, W\xc3\xb6rld! \xe2\x82\xac\xf0\x9f\x98\x80 zZ@[`{";
+    size_t plen = strlen(pattern);
+    char buf[600], ref[600];
+    int ok = 1;
+    for (size_t len = 0; len <= sizeof(buf); len += (len < 140 ? 1 : 23)) {
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = pattern[(i * 7 / 5) % plen];
+        }
+        for (int bad = 0; bad < 2; bad++) {
+            if (bad && len > 0) {
+                buf[len * 2 / 3] = (char)0xC0;
+            }
+            ok &= neon_utf8_validate(buf, len) == neon_utf8_validate_asimd(buf, len);
+            ok &= neon_utf8_count_chars(buf, len) == neon_utf8_count_chars_asimd(buf, len);
+            memcpy(ref, buf, len);
+            neon_to_upper(buf, len);
+            neon_to_upper_asimd(ref, len);
+            ok &= memcmp(buf, ref, len) == 0;
+            neon_to_lower(buf, len);
+            neon_to_lower_asimd(ref, len);
+            ok &= memcmp(buf, ref, len) == 0;
+        }
+    }
+    TEST_ASSERT(ok, "dispatched kernels match the NEON kernels");
+    
+    return 1;
+}
+
+int test_short_inputs() {
+    printf("\n=== Testing Short Inputs ===\n");
+    
+    // Under 16 bytes the UTF-8 kernels first test for ASCII with scalar
+    // loads; a high byte at any position must fall back to the full check
+    char buf[24];
+    int ok = 1;
+    for (size_t len = 1; len < sizeof(buf); len++) {
+        memset(buf, 'k', sizeof(buf));
+        size_t chars = 0;
+        ok &= neon_is_ascii(buf, len) == 1;
+        ok &= neon_utf8_validate(buf, len) == 1 && neon_utf8_validate_asimd(buf, len) == 1;
+        ok &= neon_utf8_count_chars(buf, len) == len && neon_utf8_count_chars_asimd(buf, len) == len;
+        ok &= neon_utf8_validate_count(buf, len, &chars) == 1 && chars == len;
+        for (size_t pos = 0; pos < len; pos++) {
+            memset(buf, 'k', sizeof(buf));
+            buf[pos] = (char)0xC3;                  // Truncated unless followed by A9
+            ok &= neon_is_ascii(buf, len) == 0;
+            ok &= neon_utf8_validate_asimd(buf, len) == 0;
+            ok &= neon_utf8_validate(buf, len) == 0;
+            if (pos + 1 < len) {
+                buf[pos + 1] = (char)0xA9;          // \xc3\xa9: one character in two bytes
+                ok &= neon_is_ascii(buf, len) == 0;
+                ok &= neon_utf8_validate(buf, len) == 1;
+                ok &= neon_utf8_count_chars_asimd(buf, len) == len - 1;
+                ok &= neon_utf8_validate_count(buf, len, &chars) == 1 && chars == len - 1;
+            }
+        }
+    }
+    TEST_ASSERT(ok, "ASCII and non-ASCII inputs of 1-23 bytes");
+    
+    return 1;
+}
+
+int test_stream_mode() {
+    printf("\n=== Testing Large-Buffer Mode ===\n");
+    
+    size_t default_threshold = neon_get_stream_threshold();     // src/tuning.h
+    TEST_ASSERT(default_threshold > 0, "stream threshold default");
+    neon_set_stream_threshold(64);      // Run the streaming loops on small buffers
+    
+    char buf[1000], ref[1000], out[1000];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = "aZ q\xc3\xa9M@x"[i % 9];
+    }
+    int ok = 1;
+    for (size_t len = 64; len <= sizeof(buf); len += 47) {
+        for (size_t i = 0; i < len; i++) {
+            ref[i] = (buf[i] >= 'a' && buf[i] <= 'z') ? buf[i] - 32 : buf[i];
+        }
+        neon_to_upper_copy(out, buf, len);
+        ok &= memcmp(out, ref, len) == 0;
+        memcpy(out, buf, len);
+        neon_to_upper(out, len);
+        ok &= memcmp(out, ref, len) == 0;
+        neon_to_lower(out, len);
+        neon_to_upper_copy(out, out, len);
+        ok &= memcmp(out, ref, len) == 0;
+        ok &= neon_utf8_validate(buf, len) == ((len % 9) != 5);    // 5: ends between C3 and A9
+    }
+    TEST_ASSERT(ok, "streaming case conversion and validation");
+    buf[500] = (char)0xFF;
+    TEST_ASSERT(neon_utf8_validate(buf, sizeof(buf)) == 0, "streaming validation finds errors");
+    
+    neon_set_stream_threshold(0);
+    TEST_ASSERT(neon_get_stream_threshold() == default_threshold, "stream threshold reset");
+    
+    return 1;
+}
+
+// Executor for the parallel tests: runs the workers one after another
+static void serial_spawn(void* ctx, size_t workers, neon_parallel_work_fn work, void* arg) {
+    for (size_t i = 0; i < workers; i++) {
+        work(arg);
+    }
+    *(size_t*)ctx += workers;
+}
+
+int test_parallel() {
+    printf("\n=== Testing Parallel Front End ===\n");
+    
+    // Multibyte characters of every length land across the 4 KiB chunk seams
+    const char* pattern = "Abc \xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 ";
+    size_t plen = strlen(pattern);
+    size_t len = 300 * 1024 + 13;
+    char* buf = malloc(len);
+    char* ref = malloc(len);
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = pattern[i % plen];
+    }
+    for (size_t i = len; i > 0 && (unsigned char)buf[i - 1] >= 0x80; i--) {
+        buf[i - 1] = 'x';                   // Do not end inside a character
+    }
+    
+    neon_parallel_config_t cfg = { 4, 4096, 1, NULL, NULL };
+    TEST_ASSERT(neon_utf8_validate_parallel(buf, len, &cfg) == 1, "parallel validate");
+    TEST_ASSERT(neon_utf8_count_chars_parallel(buf, len, &cfg) == neon_utf8_count_chars(buf, len),
+                "parallel count matches single-threaded count");
+    
+    memcpy(ref, buf, len);
+    neon_to_lower(ref, len);
+    neon_to_lower_parallel(buf, len, &cfg);
+    TEST_ASSERT(memcmp(buf, ref, len) == 0, "parallel to_lower");
+    neon_to_upper(ref, len);
+    neon_to_upper_parallel(buf, len, &cfg);
+    TEST_ASSERT(memcmp(buf, ref, len) == 0, "parallel to_upper");
+    char* out = malloc(len);
+    neon_to_lower(ref, len);
+    neon_to_lower_copy_parallel(out, buf, len, &cfg);
+    TEST_ASSERT(memcmp(out, ref, len) == 0, "parallel to_lower_copy");
+    neon_to_upper(ref, len);
+    neon_to_upper_copy_parallel(out, ref, len, &cfg);
+    TEST_ASSERT(memcmp(out, buf, len) == 0, "parallel to_upper_copy");
+    free(out);
+    
+    // Errors on either side of a seam, including a sequence cut by the seam
+    int ok = 1;
+    const size_t seams[] = { 4096, 3 * 4096, 64 * 4096 };
+    for (size_t s = 0; s < 3; s++) {
+        for (int d = -3; d <= 3; d++) {
+            memcpy(ref, buf, len);
+            memset(ref + seams[s] - 4, 'a', 12);
+            ref[seams[s] + d] = (char)0xF0;
+            ok &= neon_utf8_validate_parallel(ref, len, &cfg) == 0;
+            ok &= neon_utf8_validate_parallel(ref, len, &cfg) == neon_utf8_validate(ref, len);
+        }
+    }
+    TEST_ASSERT(ok, "parallel validate errors at chunk seams");
+    memcpy(ref, buf, len);
+    ref[len - 1] = (char)0xC3;
+    TEST_ASSERT(neon_utf8_validate_parallel(ref, len, &cfg) == 0, "parallel validate truncated end");
+    
+    // Caller-supplied executor, and the single-threaded path below the threshold
+    size_t spawned = 0;
+    neon_parallel_config_t custom = { 3, 8192, 1, serial_spawn, &spawned };
+    TEST_ASSERT(neon_utf8_count_chars_parallel(buf, len, &custom) == neon_utf8_count_chars(buf, len) &&
+                spawned == 3, "parallel custom executor");
+    spawned = 0;
+    custom.threshold = len + 1;
+    TEST_ASSERT(neon_utf8_validate_parallel(buf, len, &custom) == 1 && spawned == 0,
+                "parallel threshold keeps small inputs single-threaded");
+    TEST_ASSERT(neon_utf8_validate_parallel("caf\xc3\xa9", 5, NULL) == 1, "parallel default config");
+    
+    free(buf);
+    free(ref);
+    return 1;
+}
+
+int test_stats() {
+    printf("\n=== Testing Hot-Path Counters ===\n");
+    
+    neon_string_ops_stats_t st;
+    if (!neon_string_ops_stats(&st)) {
+        // Default build: the API is there but nothing is counted
+        TEST_ASSERT(st.case_calls == 0 && st.validate_calls == 0 && st.count_calls == 0,
+                    "stats are zero without instrumentation");
+        return 1;
+    }
+    
+    char buf[200];
+    memset(buf, 'a', sizeof(buf));
+    buf[150] = (char)0xFF;
+    neon_string_ops_stats_reset();
+    neon_to_upper(buf, 100);
+    neon_to_upper(buf, 10);
+    TEST_ASSERT(neon_string_ops_stats(&st) == 1 && st.case_calls == 2, "stats count case calls");
+    TEST_ASSERT(st.case_bytes_short + st.case_bytes_loop + st.case_bytes_tail == 110,
+                "stats account for every case byte");
+    
+    TEST_ASSERT(neon_utf8_validate(buf, 100) == 1 && neon_utf8_validate(buf, 200) == 0, "stats validate calls");
+    neon_utf8_count_chars(buf, 130);
+    neon_string_ops_stats(&st);
+    TEST_ASSERT(st.validate_calls == 2 && st.validate_failures == 1, "stats count validation failures");
+    TEST_ASSERT(st.validate_bytes_loop + st.validate_bytes_tail == 300, "stats account for every validated byte");
+    TEST_ASSERT(st.count_calls == 1 && st.count_bytes_loop + st.count_bytes_tail == 130,
+                "stats account for every counted byte");
+    
+    neon_string_ops_stats_reset();
+    neon_string_ops_stats(&st);
+    TEST_ASSERT(st.case_calls == 0 && st.validate_calls == 0, "stats reset");
+    
+    return 1;
+}
+
+// Test UTF-8 <-> UTF-16 / UTF-32 transcoding
+int test_utf8_transcode() {
+    printf("\n=== Testing UTF-8 Transcoding ===\n");
+    
+    const char* text = "caf\xc3\xa9 \xe4\xb8\x96 \xf0\x9f\x98\x80";
+    const uint16_t utf16[] = { 'c', 'a', 'f', 0xE9, ' ', 0x4E16, ' ', 0xD83D, 0xDE00 };
+    const uint32_t utf32[] = { 'c', 'a', 'f', 0xE9, ' ', 0x4E16, ' ', 0x1F600 };
+    uint16_t out16[32];
+    uint32_t out32[32];
+    char out8[96];
+    size_t n = 0;
+    TEST_ASSERT(neon_utf8_to_utf16(text, strlen(text), out16, &n) == 1 && n == 9 &&
+                memcmp(out16, utf16, sizeof(utf16)) == 0, "UTF-8 to UTF-16 multibyte");
+    TEST_ASSERT(neon_utf8_to_utf32(text, strlen(text), out32, &n) == 1 && n == 8 &&
+                memcmp(out32, utf32, sizeof(utf32)) == 0, "UTF-8 to UTF-32 multibyte");
+    TEST_ASSERT(neon_utf16_to_utf8(utf16, 9, out8, &n) == 1 && n == strlen(text) &&
+                memcmp(out8, text, n) == 0, "UTF-16 to UTF-8 multibyte");
+    
+    // Error offsets match neon_utf8_validate_ex
+    TEST_ASSERT(neon_utf8_to_utf16("ab\xc3\xa9\xff", 5, out16, &n) == 0 && n == 4,
+                "UTF-8 to UTF-16 invalid byte offset");
+    TEST_ASSERT(neon_utf8_to_utf32("abc\xe2\x82", 5, out32, &n) == 0 && n == 3,
+                "UTF-8 to UTF-32 truncated sequence offset");
+    TEST_ASSERT(neon_utf8_to_utf16("\xed\xa0\x80", 3, out16, &n) == 0 && n == 0,
+                "UTF-8 to UTF-16 rejects surrogate");
+    const uint16_t lone_high[] = { 'a', 0xD800, 'b' };
+    const uint16_t lone_low[] = { 0xDC00 };
+    const uint16_t end_high[] = { 'a', 'b', 0xD83D };
+    TEST_ASSERT(neon_utf16_to_utf8(lone_high, 3, out8, &n) == 0 && n == 1,
+                "UTF-16 to UTF-8 rejects unpaired high surrogate");
+    TEST_ASSERT(neon_utf16_to_utf8(lone_low, 1, out8, &n) == 0 && n == 0,
+                "UTF-16 to UTF-8 rejects unpaired low surrogate");
+    TEST_ASSERT(neon_utf16_to_utf8(end_high, 3, out8, &n) == 0 && n == 2,
+                "UTF-16 to UTF-8 rejects high surrogate at end");
+    TEST_ASSERT(neon_utf8_to_utf16("", 0, out16, NULL) == 1, "UTF-8 to UTF-16 empty string");
+    
+    // A 4-byte character at every position of an ASCII buffer: vector
+    // blocks, scalar blocks and tails, and round trips back to UTF-8
+    char block[200];
+    uint16_t* wide = malloc(sizeof(block) * sizeof(uint16_t));
+    uint32_t* wide32 = malloc(sizeof(block) * sizeof(uint32_t));
+    char* back = malloc(sizeof(block) * 3);
+    int ok = 1;
+    for (size_t pos = 0; pos + 4 <= sizeof(block); pos++) {
+        memset(block, 'a', sizeof(block));
+        memcpy(block + pos, "\xf0\x9f\x98\x80", 4);
+        ok &= neon_utf8_to_utf16(block, sizeof(block), wide, &n) == 1 && n == sizeof(block) - 2;
+        ok &= wide[0] == (pos == 0 ? 0xD83D : 'a') && wide[pos] == 0xD83D && wide[pos + 1] == 0xDE00;
+        ok &= wide[n - 1] == (pos + 4 == sizeof(block) ? 0xDE00 : 'a');
+        ok &= neon_utf16_to_utf8(wide, n, back, &n) == 1 && n == sizeof(block) &&
+              memcmp(back, block, n) == 0;
+        ok &= neon_utf8_to_utf32(block, sizeof(block), wide32, &n) == 1 && n == sizeof(block) - 3;
+        ok &= wide32[pos] == 0x1F600 && wide32[n - 1] == (pos + 4 == sizeof(block) ? 0x1F600 : 'a');
+        block[pos + 3] = 'a';
+        ok &= neon_utf8_to_utf16(block, sizeof(block), wide, &n) == 0 && n == pos;
+        ok &= neon_utf8_to_utf32(block, pos + 3, wide32, &n) == 0 && n == pos;
+    }
+    free(wide);
+    free(wide32);
+    free(back);
+    TEST_ASSERT(ok, "UTF transcoding at every block offset");
+    
+    return 1;
+}
+
+// Test UTF-8 character counting on multibyte text
+int test_utf8_count() {
+    printf("\n=== Testing UTF-8 Character Counting ===\n");
+    
+    TEST_ASSERT(neon_utf8_count_chars("caf\xc3\xa9", 5) == 4, "UTF-8 char count 2-byte");
+    TEST_ASSERT(neon_utf8_count_chars("\xe4\xb8\x96\xe7\x95\x8c", 6) == 2, "UTF-8 char count 3-byte");
+    TEST_ASSERT(neon_utf8_count_chars("\xf0\x9f\x98\x80!", 5) == 2, "UTF-8 char count 4-byte");
+    
+    // Long CJK buffer: exercises the 255-block counter folding
+    const size_t reps = 10000;
+    char* cjk = malloc(reps * 3 + 7);
+    for (size_t i = 0; i < reps; i++) {
+        memcpy(cjk + i * 3, "\xe4\xb8\x96", 3);
+    }
+    memcpy(cjk + reps * 3, "abcdefg", 7);
+    int ok = 1;
+    for (size_t extra = 0; extra <= 7; extra++) {
+        ok &= neon_utf8_count_chars(cjk, reps * 3 + extra) == reps + extra;
+    }
+    TEST_ASSERT(ok, "UTF-8 char count long CJK text");
+    
+    // Single-pass validate + count must agree with the separate calls
+    size_t chars = 0;
+    TEST_ASSERT(neon_utf8_validate_count("caf\xc3\xa9", 5, &chars) == 1 && chars == 4,
+                "UTF-8 validate_count 2-byte");
+    ok = 1;
+    for (size_t extra = 0; extra <= 7; extra++) {
+        chars = 0;
+        ok &= neon_utf8_validate_count(cjk, reps * 3 + extra, &chars) == 1;
+        ok &= chars == reps + extra;
+    }
+    ok &= neon_utf8_validate_count(cjk, reps * 3 - 1, &chars) == 0;
+    free(cjk);
+    TEST_ASSERT(ok, "UTF-8 validate_count long CJK text");
+    TEST_ASSERT(neon_utf8_validate_count("\xed\xa0\x80", 3, &chars) == 0, "UTF-8 validate_count rejects surrogate");
+    TEST_ASSERT(neon_utf8_validate_count("", 0, NULL) == 1, "UTF-8 validate_count empty string");
+    
     return 1;
 }
 
@@ -127,7 +1127,25 @@ int main() {
     
     // Run all test suites
     all_passed &= test_case_conversion();
+    all_passed &= test_casecmp_hash();
+    all_passed &= test_whitespace();
+    all_passed &= test_utf8_case();
+    all_passed &= test_batch();
+    all_passed &= test_search();
     all_passed &= test_utf8_ops();
+    all_passed &= test_utf8_validation();
+    all_passed &= test_utf8_count();
+    all_passed &= test_utf8_stream();
+    all_passed &= test_utf8_sanitize();
+    all_passed &= test_utf8_transcode();
+    all_passed &= test_base64();
+    all_passed &= test_numbers();
+    all_passed &= test_delim_scan();
+    all_passed &= test_dispatch();
+    all_passed &= test_short_inputs();
+    all_passed &= test_stream_mode();
+    all_passed &= test_parallel();
+    all_passed &= test_stats();
     
     // Run performance tests
     performance_test();
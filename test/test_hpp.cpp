@@ -0,0 +1,120 @@
+// Tests for the C++ wrapper (include/arm_string_ops.hpp)
+// Built with make test-cpp; covers both sides of inline_threshold.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "arm_string_ops.hpp"
+
+namespace aso = arm_string_ops;
+
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } else { \
+            printf("PASS: %s\n", message); \
+        } \
+    } while(0)
+
+int test_transform() {
+    printf("\n=== Testing transform<Op> ===\n");
+
+    std::string short_s = "Hello, World!";
+    aso::to_upper(short_s);
+    TEST_ASSERT(short_s == "HELLO, WORLD!", "to_upper short string (inline path)");
+    aso::transform<aso::case_op::lower>(short_s);
+    TEST_ASSERT(short_s == "hello, world!", "transform<lower> short string (inline path)");
+
+    std::string long_s = "The Quick Brown Fox Jumps Over The Lazy Dog [@`{]";
+    aso::to_upper(long_s);
+    TEST_ASSERT(long_s == "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG [@`{]", "to_upper long string (kernel path)");
+    aso::to_lower(long_s);
+    TEST_ASSERT(long_s == "the quick brown fox jumps over the lazy dog [@`{]", "to_lower long string (kernel path)");
+
+    // Every length around the threshold must agree with the scalar rule
+    const char* src = "aBcDeFgHiJkLmNoPqRsTuVwXyZ@[`{";
+    bool all_match = true;
+    for (std::size_t len = 0; len <= std::strlen(src); len++) {
+        char dst[64];
+        aso::to_upper(std::string_view(src, len), dst);
+        for (std::size_t i = 0; i < len; i++) {
+            char c = src[i];
+            char want = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+            all_match &= dst[i] == want;
+        }
+    }
+    TEST_ASSERT(all_match, "to_upper copy matches scalar at every length up to 30");
+
+#ifdef ARM_STRING_OPS_HAS_SPAN
+    std::vector<char> buf(40, 'q');
+    aso::to_upper(std::span<char>(buf));
+    TEST_ASSERT(std::string(buf.begin(), buf.end()) == std::string(40, 'Q'), "to_upper std::span overload");
+#endif
+
+    return 1;
+}
+
+int test_compare_search() {
+    printf("\n=== Testing iequals / find ===\n");
+
+    TEST_ASSERT(aso::iequals("Content-Type", "content-type"), "iequals short");
+    TEST_ASSERT(!aso::iequals("Content-Type", "content-typo"), "iequals short mismatch");
+    TEST_ASSERT(!aso::iequals("abc", "abcd"), "iequals length mismatch");
+    TEST_ASSERT(aso::iequals("ACCEPT-ENCODING: GZIP", "accept-encoding: gzip"), "iequals long");
+    TEST_ASSERT(aso::hash_lower("Host") == aso::hash_lower("hOST"), "hash_lower ignores case");
+
+    TEST_ASSERT(aso::find("hello", 'l') == 2, "find char short");
+    TEST_ASSERT(aso::find("hello", 'z') == std::string_view::npos, "find char short miss");
+    std::string text = "a fairly long sentence to search in";
+    TEST_ASSERT(aso::find(text, 'g') == text.find('g'), "find char long");
+    TEST_ASSERT(aso::find(text, '!') == std::string_view::npos, "find char long miss");
+    TEST_ASSERT(aso::find(text, "search") == text.find("search"), "find substring");
+    TEST_ASSERT(aso::find(text, "absent") == std::string_view::npos, "find substring miss");
+    TEST_ASSERT(aso::find(text, "") == 0, "find empty needle");
+    TEST_ASSERT(aso::ifind(text, "SENTENCE") == text.find("sentence"), "ifind substring");
+    TEST_ASSERT(aso::ifind(text, "absent") == std::string_view::npos, "ifind substring miss");
+
+    return 1;
+}
+
+int test_utf8_view() {
+    printf("\n=== Testing utf8_view ===\n");
+
+    TEST_ASSERT(aso::is_ascii("plain ascii text"), "is_ascii");
+    TEST_ASSERT(!aso::is_valid_utf8("\xC3\x28"), "is_valid_utf8 rejects bad sequence");
+
+    const char* text = "a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80";  // a, U+00E9, U+4E2D, U+1F600
+    auto view = aso::utf8_view::from(text);
+    TEST_ASSERT(view.has_value(), "utf8_view::from accepts valid UTF-8");
+    TEST_ASSERT(view->size() == 4, "utf8_view::size counts code points");
+
+    std::vector<char32_t> cps(view->begin(), view->end());
+    TEST_ASSERT(cps.size() == 4 && cps[0] == U'a' && cps[1] == 0xE9 &&
+                cps[2] == 0x4E2D && cps[3] == 0x1F600, "utf8_view iterator decodes code points");
+
+    TEST_ASSERT(!aso::utf8_view::from("\xED\xA0\x80").has_value(), "utf8_view::from rejects surrogates");
+
+    return 1;
+}
+
+int main() {
+    printf("ARM String Operations C++ Wrapper Tests\n");
+    printf("=======================================\n");
+
+    int all_passed = 1;
+    all_passed &= test_transform();
+    all_passed &= test_compare_search();
+    all_passed &= test_utf8_view();
+
+    printf("\n=== Test Summary ===\n");
+    if (all_passed) {
+        printf("✓ All tests PASSED!\n");
+        return 0;
+    } else {
+        printf("✗ Some tests FAILED!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,314 @@
+// ARM String Operations - File tool (make tools)
+// Runs the library over whole files without read() or intermediate buffers:
+// each input is mmap'ed and handed to the parallel kernels directly. Case
+// conversion either rewrites the input mapping in place or writes into a
+// mapping of the output file, so the data is touched once on the way from
+// the page cache to the page cache.
+//
+//   neon_strtool validate dump-*.txt
+//   neon_strtool lower --output out.txt in.txt --time
+//
+// Mappings get MADV_SEQUENTIAL (and MADV_HUGEPAGE with --hugepages, which
+// the kernel honours only where the filesystem supports large folios).
+// Case conversion of a file at or above the stream threshold runs every
+// chunk through the library's large-buffer mode (streaming prefetch,
+// non-temporal stores), so converting a multi-GB file does not flush the
+// caches of the machine. Validation and counting keep the library's normal
+// per-chunk choice.
+// With --time the throughput of each file goes to stderr, which makes the
+// tool an end-to-end benchmark including page faults; --populate maps the
+// file up front (MAP_POPULATE) to time the kernels alone.
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arm_string_ops.h"
+
+typedef enum { OP_VALIDATE, OP_COUNT, OP_UPPER, OP_LOWER } tool_op_t;
+
+typedef struct {
+    tool_op_t op;
+    const char* output;
+    int hugepages;
+    int populate;
+    int time;
+    neon_parallel_config_t par;
+} options_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Parse sizes like 4096, 64K, 16M, 1G
+static size_t parse_size(const char* s) {
+    char* end;
+    unsigned long long v = strtoull(s, &end, 0);
+    switch (*end) {
+    case 'K': case 'k': v <<= 10; break;
+    case 'M': case 'm': v <<= 20; break;
+    case 'G': case 'g': v <<= 30; break;
+    default: break;
+    }
+    return (size_t)v;
+}
+
+static void advise(void* p, size_t len, const options_t* opt) {
+    madvise(p, len, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    if (opt->hugepages) {
+        madvise(p, len, MADV_HUGEPAGE);   // Best effort: not every filesystem supports it
+    }
+#else
+    (void)opt;
+#endif
+}
+
+// Map len bytes of fd; NULL (with errno set) on failure
+static char* map_file(int fd, size_t len, int writable, const options_t* opt) {
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = writable ? MAP_SHARED : MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (opt->populate) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void* p = mmap(NULL, len, prot, flags, fd, 0);
+    if (p == MAP_FAILED) {
+        return NULL;
+    }
+    advise(p, len, opt);
+    return p;
+}
+
+// Create (or truncate) the output file, allocate its blocks and map it
+// writable. With the space reserved up front a full disk is reported here
+// instead of raising SIGBUS in the kernel
+static char* map_output(const char* path, size_t len, const options_t* opt) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || len == 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    char* p = NULL;
+    int err = posix_fallocate(fd, 0, (off_t)len);
+    if (err == 0) {
+        p = map_file(fd, len, 1, opt);
+        err = errno;
+    }
+    close(fd);
+    errno = err;
+    return p;
+}
+
+static void report_time(const char* path, size_t len, uint64_t ns) {
+    double s = (double)ns / 1e9;
+    fprintf(stderr, "%s: %zu bytes in %.3f ms (%.2f GB/s)\n",
+            path, len, s * 1e3, s > 0 ? (double)len / s / 1e9 : 0.0);
+}
+
+// Process one file; returns 0 on success, 1 if it is not valid UTF-8, 2 on errors
+static int process(const char* path, const options_t* opt) {
+    int in_place = (opt->op == OP_UPPER || opt->op == OP_LOWER) && !opt->output;
+    int fd = open(path, in_place ? O_RDWR : O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 2;
+    }
+
+    // Truncating the output would pull the data from under the input mapping
+    struct stat ost;
+    if (opt->output && stat(opt->output, &ost) == 0 &&
+        ost.st_dev == st.st_dev && ost.st_ino == st.st_ino) {
+        fprintf(stderr, "%s: --output is the input file; leave it out to convert in place\n", path);
+        close(fd);
+        return 2;
+    }
+
+    size_t len = (size_t)st.st_size;
+    char* src = NULL;
+    char* dst = NULL;
+    if (len > 0) {
+        src = map_file(fd, len, in_place, opt);
+        if (!src) {
+            fprintf(stderr, "%s: mmap: %s\n", path, strerror(errno));
+            close(fd);
+            return 2;
+        }
+    }
+    close(fd);
+
+    if (opt->output) {
+        dst = map_output(opt->output, len, opt);
+        if (!dst && len > 0) {
+            fprintf(stderr, "%s: %s\n", opt->output, strerror(errno));
+            munmap(src, len);
+            return 2;
+        }
+    }
+
+    // The parallel functions hand the kernels one chunk at a time, far below
+    // the stream threshold, so converting a file that reaches it lowers the
+    // threshold and every chunk takes the large-buffer loops. The threshold
+    // is process-wide; it is put back as soon as the conversion returns
+    size_t stream_min = neon_get_stream_threshold();
+    int convert = opt->op == OP_UPPER || opt->op == OP_LOWER;
+    if (convert && len >= stream_min) {
+        neon_set_stream_threshold(1);
+    }
+
+    int valid = 1;
+    size_t chars = 0;
+    uint64_t t0 = now_ns();
+    switch (opt->op) {
+    case OP_VALIDATE:
+        valid = neon_utf8_validate_parallel(src, len, &opt->par);
+        break;
+    case OP_COUNT:
+        chars = neon_utf8_count_chars_parallel(src, len, &opt->par);
+        break;
+    case OP_UPPER:
+        if (dst) {
+            neon_to_upper_copy_parallel(dst, src, len, &opt->par);
+        } else {
+            neon_to_upper_parallel(src, len, &opt->par);
+        }
+        break;
+    case OP_LOWER:
+        if (dst) {
+            neon_to_lower_copy_parallel(dst, src, len, &opt->par);
+        } else {
+            neon_to_lower_parallel(src, len, &opt->par);
+        }
+        break;
+    }
+    uint64_t t1 = now_ns();
+    neon_set_stream_threshold(stream_min);
+    if (opt->op == OP_VALIDATE) {
+        printf("%s: %s\n", path, valid ? "valid" : "invalid");
+    } else if (opt->op == OP_COUNT) {
+        printf("%zu %s\n", chars, path);
+    }
+    if (opt->time) {
+        report_time(path, len, t1 - t0);
+    }
+
+    // Write the converted pages back before reporting success, so an I/O
+    // error shows up in the exit status instead of being lost
+    int status = !valid;
+    char* written = dst ? dst : in_place ? src : NULL;
+    if (written && msync(written, len, MS_SYNC) != 0) {
+        fprintf(stderr, "%s: msync: %s\n", dst ? opt->output : path, strerror(errno));
+        status = 2;
+    }
+    if (dst) {
+        munmap(dst, len);
+    }
+    if (src) {
+        munmap(src, len);
+    }
+    return status;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s validate|count|upper|lower [options] FILE...\n"
+            "  --output PATH        upper/lower: write to PATH (one FILE) instead of in place\n"
+            "  --threads N          worker threads (default: online CPUs)\n"
+            "  --chunk N            bytes per work item, K/M/G suffixes allowed (default 512K)\n"
+            "  --parallel-min N     smallest file split across threads (default 4M)\n"
+            "  --stream-min N|off   smallest file converted with non-temporal stores (default 16M)\n"
+            "  --hugepages          request transparent huge pages for the mappings\n"
+            "  --populate           prefault the mappings before processing\n"
+            "  --time               print the throughput of each file to stderr\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    options_t opt;
+    memset(&opt, 0, sizeof(opt));
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char* op = argv[1];
+    if (strcmp(op, "validate") == 0) {
+        opt.op = OP_VALIDATE;
+    } else if (strcmp(op, "count") == 0) {
+        opt.op = OP_COUNT;
+    } else if (strcmp(op, "upper") == 0) {
+        opt.op = OP_UPPER;
+    } else if (strcmp(op, "lower") == 0) {
+        opt.op = OP_LOWER;
+    } else {
+        usage(argv[0]);
+        return op[0] == '-' && op[1] == '-' && op[2] == 'h' ? 0 : 2;
+    }
+
+    const char** files = malloc((size_t)argc * sizeof(*files));
+    int nfiles = 0;
+    for (int i = 2; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (a[0] != '-' || a[1] != '-') {
+            files[nfiles++] = a;
+            continue;
+        }
+        if (strcmp(a, "--hugepages") == 0) {
+            opt.hugepages = 1;
+            continue;
+        } else if (strcmp(a, "--populate") == 0) {
+            opt.populate = 1;
+            continue;
+        } else if (strcmp(a, "--time") == 0) {
+            opt.time = 1;
+            continue;
+        }
+        if (v && strcmp(a, "--output") == 0) {
+            opt.output = v;
+        } else if (v && strcmp(a, "--threads") == 0) {
+            opt.par.threads = (size_t)atoi(v);
+        } else if (v && strcmp(a, "--chunk") == 0) {
+            opt.par.chunk_size = parse_size(v);
+        } else if (v && strcmp(a, "--parallel-min") == 0) {
+            opt.par.threshold = parse_size(v);
+        } else if (v && strcmp(a, "--stream-min") == 0) {
+            neon_set_stream_threshold(strcmp(v, "off") == 0 ? SIZE_MAX : parse_size(v));
+        } else {
+            usage(argv[0]);
+            free(files);
+            return strcmp(a, "--help") == 0 ? 0 : 2;
+        }
+        i++;
+    }
+
+    if (nfiles == 0 || (opt.output && (nfiles != 1 || opt.op == OP_VALIDATE || opt.op == OP_COUNT))) {
+        usage(argv[0]);
+        free(files);
+        return 2;
+    }
+
+    int status = 0;
+    for (int i = 0; i < nfiles; i++) {
+        int s = process(files[i], &opt);
+        status = s > status ? s : status;
+    }
+    free(files);
+    return status;
+}